@@ -0,0 +1,52 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "map_loader.h"
+
+// ============= قياسات الأداء =============
+#define BENCH_REPEATS 3
+#define BENCH_TEXT_FILE "data/bench_map.txt"
+#define BENCH_TEXT_SIDE 220          // ملف نصي مُولَّد بحجم عشرات الميغابايت
+#define BENCH_TEXT_DEPTH 64
+
+double bench_now(void);
+
+// سرعة قراءة الصيغة النصية على ملف مُولَّد كبير (دون طباعة المحمّلات)
+void benchmark_text_map_loader(const char *filename);
+
+// التخزين بالكتل: الذاكرة وزمن القراءة العشوائية مقابل الشبكة الكثيفة
+void benchmark_sparse_storage(const Map3D *map);
+
+// وسم مكونات الفراغ المتصلة (المطلوب: أقل بكثير من ثانية لـ 10^7 خلية)
+void benchmark_components(const Map3D *map);
+
+// ترتيب الخلايا: خطي مقابل Morton على مسارات المشي وفحص الجوار
+void benchmark_layouts(const Map3D *map);
+
+// تخزين الجينات: تعداد 4 بايت مقابل بايت واحد مقابل 3 بتات
+void benchmark_genes(void);
+
+// ساحة المجتمع المزدوجة مقابل حجز الذاكرة لكل فرد في كل جيل
+void benchmark_population_arena(const Map3D *map);
+
+// إعادة التقييم من نقاط الحفظ بعد طفرات قليلة مقابل مرور كامل
+void benchmark_incremental_eval(const Map3D *map);
+
+// ذاكرة اللياقة المؤقتة على مجتمع متقارب (نسخ مكررة كثيرة)
+void benchmark_fitness_cache(const Map3D *map);
+
+// البادئات المشتركة بعد التهجين: استئناف من أطول بادئة محفوظة
+void benchmark_prefix_cache(const Map3D *map);
+
+// التقييم الدفعي: مطابقة النوى مع التقييم العادي وزمن كل نواة (عادي/SSE4/AVX2)
+void benchmark_batch_eval(const Map3D *map);
+
+// الانتقاء: جداول Alias للعجلة والرتبة مقابل المسح الخطي لكل سحبة
+void benchmark_selection(void);
+
+// الترتيب: الفرز الجذري وكومة أفضل k والاختيار الجزئي مقابل qsort
+void benchmark_ranking(void);
+
+void run_benchmarks(const Map3D *map);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,53 @@
+#ifndef CACHE_SHARDS_H
+#define CACHE_SHARDS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <omp.h>
+#include "rng.h"
+
+// ============= بصمة كتل الجينات =============
+// بصمة 128 بت تُبنى كلمة 64 بت بعد أخرى؛ الموضع يدخل في البصمة.
+// مشتركة بين ذاكرة اللياقة وذاكرة البادئات.
+typedef struct {
+    uint64_t lo, hi;
+} GeneKey;
+
+static inline void gene_key_init(GeneKey *key)
+{
+    key->lo = 0x243F6A8885A308D3ULL;
+    key->hi = 0x13198A2E03707344ULL;
+}
+
+static inline void gene_key_add_word(GeneKey *key, uint64_t word, uint64_t index)
+{
+    key->lo = rng_rotl(key->lo ^ rng_mix64(word + index * 0x9E3779B97F4A7C15ULL), 23) * 0xff51afd7ed558ccdULL;
+    key->hi = rng_rotl(key->hi + rng_mix64(word ^ (index * 0xC2B2AE3D27D4EB4FULL) ^ 0x5851F42D4C957F2DULL), 41)
+              * 0xc4ceb9fe1a85ec53ULL;
+}
+
+// خلط نهائي مع ما لا تحمله الكلمات (الطول، خلية البداية...)
+static inline void gene_key_finish(GeneKey *key, uint64_t shape)
+{
+    key->lo = rng_mix64(key->lo ^ shape);
+    key->hi = rng_mix64(key->hi ^ rng_rotl(shape, 32));
+}
+
+// ============= أقفال الأقسام =============
+// كل قسم يبدأ بـ ShardLock فيأخذ سطر ذاكرة خاصاً به
+typedef struct {
+    _Alignas(64) omp_lock_t lock;
+} ShardLock;
+
+// البنية الرئيسية للذاكرة: محاذاة 64 بايت ومصفّرة، أو NULL
+void *sharded_cache_alloc(size_t bytes);
+
+// count قسماً متتالياً، حجم كل منها stride بايت
+void shard_locks_init(void *shards, size_t stride, int count);
+void shard_locks_destroy(void *shards, size_t stride, int count);
+
+static inline void shard_lock(ShardLock *shard) { omp_set_lock(&shard->lock); }
+static inline void shard_unlock(ShardLock *shard) { omp_unset_lock(&shard->lock); }
+
+#endif // CACHE_SHARDS_H
@@ -2,7 +2,10 @@
 #define CHROMOSOME_H
 
 #include "map_loader.h"
+#include "rng.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
 
 // ============= تعريف الاتجاهات =============
 typedef enum {
@@ -15,11 +18,48 @@ typedef enum {
     DIR_WAIT = 6        // البقاء في المكان
 } Direction;
 
+// ============= ترميز الجينات =============
+// كل حركة تُخزَّن في بايت واحد (قيمة Direction)
+typedef uint8_t Gene;
+
+// التخزين المضغوط: 3 بتات لكل جين، 21 جيناً في كل كلمة 64 بت
+#define GENE_BITS 3
+#define GENE_MASK 0x7u
+#define GENES_PER_WORD 21
+
+static inline size_t packed_gene_words(int count)
+{
+    return ((size_t)count + GENES_PER_WORD - 1) / GENES_PER_WORD;
+}
+
+static inline Gene packed_gene_get(const uint64_t *words, int i)
+{
+    return (Gene)((words[i / GENES_PER_WORD] >> (GENE_BITS * (i % GENES_PER_WORD))) & GENE_MASK);
+}
+
+static inline void packed_gene_set(uint64_t *words, int i, Gene g)
+{
+    int shift = GENE_BITS * (i % GENES_PER_WORD);
+    uint64_t *w = &words[i / GENES_PER_WORD];
+    *w = (*w & ~((uint64_t)GENE_MASK << shift)) | ((uint64_t)(g & GENE_MASK) << shift);
+}
+
+void pack_genes(const Gene *genes, int count, uint64_t *words);
+void unpack_genes(const uint64_t *words, int count, Gene *genes);
+void packed_genes_crossover(const uint64_t *a, const uint64_t *b, int point,
+                            int count, uint64_t *child);
+
+// سجل التقييم التدريجي (معرّف في path_eval.h)
+typedef struct EvalTrace EvalTrace;
+
+// dirty_from لكروموسوم لم تتغير جيناته منذ آخر تقييم
+#define CHROMOSOME_CLEAN INT_MAX
+
 // ============= هيكل الكروموسوم (مسار واحد) =============
 typedef struct {
     // البيانات الأساسية
     Position start_pos;          // نقطة البداية
-    Direction *moves;            // مصفوفة الاتجاهات
+    Gene *moves;                 // مصفوفة الاتجاهات (بايت لكل حركة)
     int num_moves;               // عدد الحركات الفعلية
     int max_moves;               // السعة القصوى
     
@@ -36,8 +76,20 @@ typedef struct {
     bool valid;                  // هل المسار صالح؟
     Position *actual_path;       // المسار الفعلي (مخزن مؤقت)
     int actual_path_length;      // طول المسار الفعلي
+    
+    // التقييم التدريجي
+    EvalTrace *trace;            // نقاط حفظ آخر تقييم (NULL = لا يوجد)
+    int dirty_from;              // أول جين تغيّر منذ آخر تقييم
 } Chromosome;
 
+// كل تعديل مباشر على moves يجب أن يُبلَّغ به قبل التقييم التدريجي
+static inline void chromosome_mark_dirty(Chromosome *chrom, int from) {
+    if (from < chrom->dirty_from) chrom->dirty_from = from;
+}
+
+// جداول الانتقاء لكل جيل (معرّفة في selection.h)
+typedef struct SelectionTables SelectionTables;
+
 // ============= هيكل المجتمع =============
 typedef struct {
     Chromosome *individuals;     // مصفوفة الكروموسومات
@@ -49,6 +101,8 @@ typedef struct {
     float best_fitness;          // أفضل لياقة
     float avg_fitness;           // متوسط اللياقة
     float worst_fitness;         // أسوأ لياقة
+    
+    SelectionTables *selection;  // تُبنى بـ prepare_selection، أو NULL
 } Population;
 
 // ============= دوال الكروموسوم =============
@@ -66,16 +120,29 @@ void free_chromosome(Chromosome *chrom);
 Position* decode_chromosome_to_path(const Chromosome *chrom, int *path_length);
 Position* decode_chromosome_with_bounds(const Chromosome *chrom, int *path_length, 
                                         const Map3D *map);
+void decode_moves_with_bounds(const Gene *moves, int count, Position start,
+                              const Map3D *map, Position *path);
 bool is_valid_move(const Chromosome *chrom, int move_index, const Map3D *map);
 bool validate_chromosome(const Chromosome *chrom, const Map3D *map);
 void repair_chromosome(Chromosome *chrom, const Map3D *map);
 
-// التقييم
+// التقييم (مرور واحد بدون حجز ذاكرة، انظر path_eval.h)
 float evaluate_chromosome_fitness(Chromosome *chrom, const Map3D *map, 
                                   float w_survivors, float w_coverage, 
                                   float w_length, float w_risk);
+// يبني actual_path عند الطلب فقط (التقييم لا يحتفظ به)
+bool build_chromosome_path(Chromosome *chrom, const Map3D *map);
+// يعيد التقييم من آخر نقطة حفظ قبل أول جين متغير
+float evaluate_chromosome_incremental(Chromosome *chrom, const Map3D *map,
+                                      float w_survivors, float w_coverage,
+                                      float w_length, float w_risk);
 int count_survivors_on_path(const Chromosome *chrom, const Map3D *map);
 int count_coverage_cells(const Chromosome *chrom, const Map3D *map);
+// بدون حجز ذاكرة: المخزن صفري عند الدخول ويعود صفرياً عند الخروج
+int count_survivors_in_path(const Position *path, int length, const Map3D *map,
+                            uint64_t *found);
+int count_cells_in_path(const Position *path, int length, const Map3D *map,
+                        uint64_t *visited);
 float calculate_path_length(const Chromosome *chrom);
 float calculate_path_risk(const Chromosome *chrom, const Map3D *map);
 
@@ -90,12 +157,21 @@ void crossover_chromosomes(const Chromosome *parent1, const Chromosome *parent2,
                            Chromosome *child1, Chromosome *child2, 
                            float crossover_rate);
 
+// نفس العمليات على مصفوفات الجينات مباشرة (بدون حجز ذاكرة)
+// تعيد mutate_genes أول موضع تغيّر (أو count)، و crossover_genes طول
+// البادئة المشتركة بين كل ابن وأبيه الأول
+int mutate_genes(Rng *rng, Gene *genes, int count, float mutation_rate);
+int crossover_genes(Rng *rng, const Gene *a, int na, const Gene *b, int nb,
+                     Gene *child1, int *n1, Gene *child2, int *n2,
+                     float crossover_rate);
+
 // العرض والطباعة
 void print_chromosome(const Chromosome *chrom);
 void print_chromosome_directions(const Chromosome *chrom);
 void print_chromosome_path(const Chromosome *chrom);
 void print_chromosome_stats(const Chromosome *chrom);
 void save_chromosome_to_file(const Chromosome *chrom, const char *filename);
+Chromosome* load_chromosome_from_file(const char *filename);
 
 // ============= دوال المجتمع =============
 
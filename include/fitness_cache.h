@@ -0,0 +1,54 @@
+#ifndef FITNESS_CACHE_H
+#define FITNESS_CACHE_H
+
+#include "path_eval.h"
+#include "cache_shards.h"
+
+// ============= مفتاح الجينات =============
+// بصمة 128 بت للتسلسل الفعلي للحركات: الحركات التي ترتد عن الحدود تُعامل
+// كانتظار، والانتظار في نهاية المسار لا يدخل في البصمة (الطول يدخل فيها)
+// يعيد false إذا كانت البداية خارج الخريطة (لا يُخزَّن مثل هذا المسار)
+bool gene_key_canonical(const Gene *moves, int num_moves, Position start,
+                        const Map3D *map, GeneKey *key);
+
+// ============= ذاكرة اللياقة المؤقتة =============
+// محدودة الحجم ومتزامنة: مجموعات من 8 مداخل مع إخلاء CLOCK داخل كل
+// مجموعة، والمجموعات موزعة على أقفال منفصلة. تُخزَّن المقاييس لا اللياقة،
+// فتغيير الأوزان لا يُبطلها. خاصة بخريطة واحدة.
+#define FITNESS_CACHE_WAYS 8
+#define FITNESS_CACHE_SHARDS 64
+#define FITNESS_CACHE_DEFAULT_ENTRIES (1 << 16)
+
+typedef struct FitnessCache FitnessCache;
+typedef struct PrefixCache PrefixCache;     // prefix_cache.h
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+    uint64_t evictions;
+    size_t capacity;
+} FitnessCacheStats;
+
+FitnessCache* fitness_cache_create(size_t entries, const Map3D *map);
+void fitness_cache_free(FitnessCache *cache);
+void fitness_cache_clear(FitnessCache *cache);
+
+bool fitness_cache_lookup(FitnessCache *cache, GeneKey key, PathMetrics *out);
+void fitness_cache_insert(FitnessCache *cache, GeneKey key, const PathMetrics *metrics);
+
+// تقييم عبر الذاكرة المؤقتة؛ عند عدم الوجود يُحسب المسار مستأنفاً من
+// أطول بادئة محفوظة في prefixes (إن وُجدت)
+bool evaluate_path_cached(const Gene *moves, int num_moves, Position start,
+                          const Map3D *map, EvalWorkspace *ws,
+                          FitnessCache *cache, PrefixCache *prefixes,
+                          float w_survivors, float w_coverage,
+                          float w_length, float w_risk, PathMetrics *out);
+float evaluate_chromosome_cached(Chromosome *chrom, const Map3D *map, FitnessCache *cache,
+                                 float w_survivors, float w_coverage,
+                                 float w_length, float w_risk);
+
+void fitness_cache_get_stats(const FitnessCache *cache, FitnessCacheStats *stats);
+void fitness_cache_print_stats(const FitnessCache *cache);
+
+#endif // FITNESS_CACHE_H
@@ -0,0 +1,37 @@
+#ifndef GA_H
+#define GA_H
+
+#include "population_arena.h"
+
+// ============= الخوارزمية الجينية =============
+// كل الذاكرة تُحجز قبل الجيل الأول: جيلان متبادلان (population_arena.h)
+// ومصفوفة فهارس للنخبة. لا malloc/free ولا فرز كامل داخل حلقة الأجيال:
+// النخبة تُختار جزئياً والانتقاء بالبطولة يقرأ مصفوفة اللياقة فقط.
+
+// عدد الأزواج في كل دفعة تهجين (تدفق عشوائي مستقل لكل دفعة)
+#define GA_BREED_CHUNK 64
+
+// تُستخدم ذاكرة اللياقة فقط إذا كان متوقعاً أن يتكرر هذا الجزء من الأبناء دون تغيير
+#define GA_CACHE_MIN_REPEATS 0.10
+
+// وذاكرة البادئات فقط إذا كان متوقعاً أن يُستأنف هذا الجزء من كتل الأبناء من بادئة محفوظة
+#define GA_PREFIX_MIN_REUSE 0.25
+
+typedef struct {
+    int generations;             // أجيال نُفذت بعد الجيل الأول
+    int best_generation;         // الجيل الذي ظهر فيه الأفضل
+    float best_fitness;
+    double total_seconds;
+    double breed_seconds;        // الانتقاء والنخبة والتهجين والطفرة
+    double eval_seconds;
+    double slowest_generation;   // أبطأ جيل (ثوانٍ)
+    Chromosome *best;            // نسخة من أفضل مسار
+} GAResult;
+
+// يشغّل الخوارزمية بإعدادات POPULATION_SIZE, GENERATIONS, ELITISM_RATE,
+// CROSSOVER_RATE, MUTATION_RATE, TOURNAMENT_SIZE, MAX_PATH_LENGTH
+GAResult *run_ga(const Settings *settings, const Map3D *map);
+void print_ga_result(const GAResult *result);
+void free_ga_result(GAResult *result);
+
+#endif // GA_H
@@ -0,0 +1,58 @@
+#ifndef MAP_BRICKS_H
+#define MAP_BRICKS_H
+
+#include "map_loader.h"
+
+// ============= التخزين المتفرق بالكتل =============
+// الخريطة مقسمة إلى كتل 8×8×8؛ الكتلة المتجانسة (كلها ركام أو كلها فراغ)
+// تُخزن كبايت واحد فقط، ولا تُحجز بياناتها إلا عند أول كتابة مختلفة.
+// تُستخدم عبر نفس دوال الوصول (map_cell_at, map_set_cell_at ...).
+#define MAP_BRICK_SHIFT 3
+#define MAP_BRICK_DIM (1 << MAP_BRICK_SHIFT)
+#define MAP_BRICK_MASK (MAP_BRICK_DIM - 1)
+#define MAP_BRICK_CELLS (MAP_BRICK_DIM * MAP_BRICK_DIM * MAP_BRICK_DIM)
+
+// الخرائط النصية الأكبر من هذا تُحمّل بالتخزين المتفرق تلقائياً
+#define MAP_SPARSE_MIN_CELLS ((size_t)1 << 28)
+
+struct MapBricks {
+    int bricks_x, bricks_y, bricks_z;
+    size_t brick_count;
+    uint8_t *uniform;            // قيمة كل خلايا الكتلة b عندما data[b] == NULL
+    uint8_t **data;              // 512 خلية بترتيب [z][y][x] أو NULL
+    size_t allocated;            // عدد الكتل المحجوزة فعلاً
+};
+
+MapBricks *map_bricks_create(int width, int height, int depth);
+void map_bricks_free(MapBricks *bricks);
+
+static inline size_t map_brick_id(const MapBricks *bricks, int x, int y, int z)
+{
+    return ((size_t)(z >> MAP_BRICK_SHIFT) * bricks->bricks_y + (y >> MAP_BRICK_SHIFT)) *
+           bricks->bricks_x + (x >> MAP_BRICK_SHIFT);
+}
+
+static inline unsigned map_brick_offset(int x, int y, int z)
+{
+    return ((unsigned)(z & MAP_BRICK_MASK) << (2 * MAP_BRICK_SHIFT)) |
+           ((unsigned)(y & MAP_BRICK_MASK) << MAP_BRICK_SHIFT) |
+           (unsigned)(x & MAP_BRICK_MASK);
+}
+
+static inline uint8_t map_brick_cell_xyz(const MapBricks *bricks, int x, int y, int z)
+{
+    size_t b = map_brick_id(bricks, x, y, z);
+    const uint8_t *data = bricks->data[b];
+    return data ? data[map_brick_offset(x, y, z)] : bricks->uniform[b];
+}
+
+bool map_brick_set(MapBricks *bricks, int x, int y, int z, uint8_t type);
+size_t map_bricks_count_cells(const Map3D *map, int z_first, int z_count, uint8_t type);
+
+// يعيد الكتل المحجوزة التي أصبحت متجانسة إلى بايت واحد (طبقات z من first_layer)
+size_t map_compact_bricks(Map3D *map, int first_layer, int layer_count);
+
+// الذاكرة المستخدمة لتخزين الخلايا (كثيف أو متفرق)
+size_t map_storage_bytes(const Map3D *map);
+
+#endif // MAP_BRICKS_H
@@ -0,0 +1,21 @@
+#ifndef MAP_COMPONENTS_H
+#define MAP_COMPONENTS_H
+
+#include "map_loader.h"
+
+// ============= مكونات الفراغ المتصلة =============
+// وسم المكونات (6 اتجاهات) على مقاطع الصفوف مع union-find؛ الركام فقط يفصل.
+// الناجي "قابل للرصد" إذا كانت إحدى خلايا جواره (27 خلية) في مكوّن البداية.
+bool map_label_components(Map3D *map);
+
+static inline bool map_survivor_reachable(const Map3D *map, int survivor)
+{
+    return !map->survivor_reachable || map->survivor_reachable[survivor];
+}
+
+// أعلى لياقة ممكنة لمسار صالح: كل الناجين القابلين للرصد وأكبر تغطية ممكنة
+float map_fitness_upper_bound(const Map3D *map, float w_survivors, float w_coverage, int max_moves);
+
+void print_map_reachability(const Map3D *map);
+
+#endif // MAP_COMPONENTS_H
@@ -0,0 +1,42 @@
+#ifndef MAP_DISTANCE_H
+#define MAP_DISTANCE_H
+
+#include "map_loader.h"
+
+// ============= حقول المسافة (BFS) =============
+// عدد الخطوات (6 اتجاهات) من أقرب مصدر؛ العوائق فقط تحجب الحركة
+#define DIST_UNREACHABLE 0xFFFFu
+#define DIST_MAX 0xFFFEu             // المسافات الأطول تُقص إلى هذه القيمة
+
+// حقل لكل ناجٍ ما دام العدد صغيراً، وإلا حقل لكل مجموعة ناجين متجاورين
+#define DIST_MAX_GROUPS 32
+#define DIST_GROUP_BUDGET ((size_t)256 << 20)
+
+// BFS متعدد المصادر بطابور دائري؛ out بحجم cell_count
+bool map_bfs_distance(const Map3D *map, const size_t *sources, size_t source_count, uint16_t *out);
+
+// البداية والمخرج وأقرب ناجٍ ومجموعات الناجين؛ الحقول المستقلة تُحسب بالتوازي
+bool map_build_distance_fields(Map3D *map);
+
+static inline uint16_t map_distance_from_start(const Map3D *map, size_t idx)
+{
+    return map->dist_start ? map->dist_start[idx] : DIST_UNREACHABLE;
+}
+
+static inline uint16_t map_distance_to_exit(const Map3D *map, size_t idx)
+{
+    return map->dist_exit ? map->dist_exit[idx] : DIST_UNREACHABLE;
+}
+
+static inline uint16_t map_distance_to_survivors(const Map3D *map, size_t idx)
+{
+    return map->dist_survivors ? map->dist_survivors[idx] : DIST_UNREACHABLE;
+}
+
+// حقل المجموعة g (تحتوي الناجي s إذا survivor_group[s] == g)
+static inline const uint16_t *map_group_distance_field(const Map3D *map, int group)
+{
+    return map->dist_groups + (size_t)group * map->cell_count;
+}
+
+#endif // MAP_DISTANCE_H
@@ -0,0 +1,38 @@
+#ifndef MAP_FIELDS_H
+#define MAP_FIELDS_H
+
+#include "map_loader.h"
+
+// ============= حقل الخطر =============
+// نصف قطر نافذة الخطر (5×5×5) ووزن العائق: 1 / (المسافة + 1)
+#define RISK_RADIUS 2
+
+// يحسب خطر كل خلية مرة واحدة (الخريطة ثابتة أثناء التشغيل)
+bool map_build_risk_field(Map3D *map);
+float map_compute_cell_risk(const Map3D *map, size_t idx);
+
+static inline float map_risk_at(const Map3D *map, size_t idx)
+{
+    return map->risk_field ? map->risk_field[idx] : map_compute_cell_risk(map, idx);
+}
+
+// ============= قوائم رصد الناجين (CSR) =============
+// لكل خلية: الناجون الواقعون ضمن نصف قطر 1 (27 خلية) منها
+#define DETECTION_RADIUS 1
+
+bool map_build_detection_lists(Map3D *map);
+
+// بدون قوائم CSR (التخزين المتفرق): مسح الجوار في مخزن خاص بكل خيط
+const int32_t *map_scan_detectable_survivors(const Map3D *map, size_t idx, int *count);
+
+static inline const int32_t *map_detectable_survivors(const Map3D *map, size_t idx, int *count)
+{
+    if (!map->detect_offsets)
+        return map_scan_detectable_survivors(map, idx, count);
+
+    uint32_t begin = map->detect_offsets[idx];
+    *count = (int)(map->detect_offsets[idx + 1] - begin);
+    return &map->detect_ids[begin];
+}
+
+#endif // MAP_FIELDS_H
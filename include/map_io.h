@@ -0,0 +1,70 @@
+#ifndef MAP_IO_H
+#define MAP_IO_H
+
+#include "map_loader.h"
+
+// ============= اللقطة الثنائية للخريطة =============
+// ترويسة + جدول أقسام؛ كل قسم محاذى على 64 بايت بحيث يمكن ربط الملف
+// بالذاكرة واستخدام المصفوفات مباشرة دون أي تحليل.
+#define MAP_SNAPSHOT_MAGIC "RSMAPBIN"
+#define MAP_SNAPSHOT_VERSION 3
+#define MAP_SNAPSHOT_MAX_SECTIONS 24
+
+typedef enum {
+    SNAP_SECTION_CELLS = 1,
+    SNAP_SECTION_OBSTACLE_BITS,
+    SNAP_SECTION_SURVIVOR_BITS,
+    SNAP_SECTION_SURVIVORS,
+    SNAP_SECTION_SURVIVOR_IDS,
+    SNAP_SECTION_SURVIVOR_TABLE,
+    SNAP_SECTION_RISK_FIELD,
+    SNAP_SECTION_DETECT_OFFSETS,
+    SNAP_SECTION_DETECT_IDS,
+    SNAP_SECTION_DIST_START,
+    SNAP_SECTION_DIST_EXIT,
+    SNAP_SECTION_DIST_SURVIVORS,
+    SNAP_SECTION_DIST_GROUPS,
+    SNAP_SECTION_SURVIVOR_GROUPS,
+    SNAP_SECTION_SURVIVOR_REACHABLE,
+    SNAP_SECTION_COMPONENT_STATS,
+    SNAP_SECTION_RUBBLE_SUMS
+} SnapshotSectionId;
+
+typedef struct {
+    uint32_t id;
+    uint32_t reserved;
+    uint64_t offset;             // من بداية الملف
+    uint64_t size;               // بالبايت
+} SnapshotSection;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;         // 0x01020304 بترتيب الجهاز الذي كتب الملف
+    uint32_t header_size;
+    uint32_t survivor_record_size;
+    int32_t width, height, depth;
+    int32_t survivor_count;
+    Position start_position;
+    Position exit_position;
+    uint64_t cell_count;
+    uint64_t bitmap_words;
+    uint64_t survivor_table_mask;
+    uint32_t section_count;
+    uint32_t layout;             // MapLayout
+    SnapshotSection sections[MAP_SNAPSHOT_MAX_SECTIONS];
+} MapSnapshotHeader;
+
+bool save_map_snapshot(const Map3D *map, const char *filename);
+Map3D *load_map_mmap(const char *filename);
+
+// ============= قراءة صيغة الخريطة النصية =============
+// نفس صيغة save_map_to_file و draw-map.py:
+// ترويسة WIDTH=/HEIGHT=/DEPTH= ثم أسطر x,y,z,type[,priority,heat,co2,confidence,location]
+#define MAP_TEXT_BLOCK_SIZE (4 << 20)
+
+Map3D *load_map_from_text(const char *filename);
+// التحليل فقط: الخلايا والناجون دون البيانات المشتقة
+Map3D *load_map_cells_from_text(const char *filename);
+
+#endif // MAP_IO_H
@@ -2,11 +2,44 @@
 #define MAP_LOADER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// محاذاة مخزن الخلايا على حدود سطر الذاكرة المؤقتة
+#define MAP_CACHE_LINE 64
+
+// رموز الخلايا (بايت واحد لكل خلية)؛ الرموز الفردية تحجب الحركة
+typedef enum {
+    CELL_FREE = 0,
+    CELL_OBSTACLE = 1,
+    CELL_SURVIVOR = 2,
+    CELL_BORDER = 3              // إطار حارس حول الخريطة (ليس ركاماً)
+} CellType;
+
+// سماكة الإطار الحارس: كل خلية داخلية لها جيران الستة في المصفوفة
+#define MAP_PAD 1
+
+// الحركات بترتيب Direction: +x, -x, +y, -y, +z, -z, انتظار
+#define MAP_MOVE_COUNT 7
+#define MAP_MOVE_NEXT_X 0            // = DIR_RIGHT، للمرور على صف
+
+// ترتيب الخلايا في الذاكرة (يُختار عند إنشاء الخريطة)
+typedef enum {
+    MAP_LAYOUT_LINEAR = 0,           // صفوف [z][y][x]
+    MAP_LAYOUT_MORTON = 1            // كتل 8×8×8 بترتيب Morton داخل كل كتلة
+} MapLayout;
+
+// ترميز Morton داخل الكتلة: بتات x في 0,3,6 و y في 1,4,7 و z في 2,5,8
+#define MAP_MORTON_SHIFT 3
+#define MAP_MORTON_BITS (3 * MAP_MORTON_SHIFT)
+#define MAP_MORTON_X 0x049u
 
 typedef struct {
     int x, y, z;
 } Position;
 
+extern const Position map_move_offsets[MAP_MOVE_COUNT];
+
 typedef struct {
     Position pos;
     int priority;
@@ -17,11 +50,59 @@ typedef struct {
     int sensor_confidence;
 } Survivor;
 
+// خانة في جدول التجزئة: فهرس الخلية -> رقم الناجي
+typedef struct {
+    uint64_t cell;               // UINT64_MAX = خانة فارغة
+    int32_t id;
+} SurvivorSlot;
+
+#define SURVIVOR_SLOT_EMPTY UINT64_MAX
+
+// تخزين متفرق بكتل 8×8×8 (انظر map_bricks.h)
+typedef struct MapBricks MapBricks;
+
+// نتيجة وسم مكونات الفراغ (انظر map_components.h)
+typedef struct {
+    uint64_t component_count;        // عدد مكونات الفراغ المتصلة
+    uint64_t start_component_cells;  // خلايا المكوّن الذي يحوي نقطة البداية
+    int32_t reachable_survivors;     // الناجون القابلون للرصد من البداية
+    int32_t reserved;
+} MapComponentStats;
+
 typedef struct {
     int width, height, depth;
-    int ***grid;
+    uint8_t *cells;              // مخزن واحد متصل بترتيب layout، أو NULL مع bricks
+    MapBricks *bricks;           // التخزين المتفرق، أو NULL للخرائط الكثيفة
+    MapLayout layout;
+    size_t cell_count;           // طول فضاء الفهارس مع الإطار: (w+2)(h+2)(d+2) خطياً
+    size_t volume;               // الخلايا الداخلية: width * height * depth
+    size_t stride_y, stride_z;   // خطوة الصف والطابق (الترتيب الخطي)
+    size_t blocks_x, blocks_y;   // عدد كتل Morton على x و y
+    size_t origin;               // فهرس الخلية (0, 0, 0)
+    ptrdiff_t move_delta[MAP_MOVE_COUNT]; // خطي: إزاحة الفهرس؛ Morton: إزاحة الكتلة المجاورة
+    uint64_t *obstacle_bits;     // بت لكل خلية: 1 = عائق أو إطار (NULL مع bricks)
+    uint64_t *survivor_bits;     // بت لكل خلية: 1 = ناجٍ (NULL مع bricks)
+    size_t bitmap_words;         // عدد الكلمات (64 بت) في كل خريطة بتات
     Survivor *survivors;
     int survivor_count;
+    int32_t *survivor_ids;       // فهرس كثيف خلية -> ناجٍ (-1 = لا يوجد)، أو NULL
+    SurvivorSlot *survivor_table;// جدول تجزئة مضغوط للخرائط المتفرقة، أو NULL
+    size_t survivor_table_mask;  // حجم الجدول - 1 (قوة للعدد 2)
+    float *risk_field;           // خطر العوائق المحيطة بكل خلية (محسوب مسبقاً)
+    uint32_t *rubble_sums;       // جدول المجاميع الحجمية للركام (map_volume.h)، أو NULL
+    uint32_t *detect_offsets;    // CSR: بداية قائمة الناجين المرصودين من كل خلية
+    int32_t *detect_ids;         // CSR: أرقام الناجين ضمن نصف قطر 1
+    uint16_t *dist_start;        // مسافة BFS من نقطة البداية (انظر map_distance.h)
+    uint16_t *dist_exit;         // مسافة BFS إلى المخرج
+    uint16_t *dist_survivors;    // مسافة BFS إلى أقرب ناجٍ قابل للرصد
+    uint16_t *dist_groups;       // dist_group_count حقلاً متتالياً، واحد لكل مجموعة ناجين
+    int32_t *survivor_group;     // مجموعة كل ناجٍ
+    int dist_group_count;
+    uint8_t *survivor_reachable; // 1 = يمكن رصد الناجي من مكوّن البداية، أو NULL
+    MapComponentStats components;
+    uint64_t serial;             // يتغير عند إنشاء الخريطة أو إعادة بناء بياناتها (لا يتكرر)
+    void *mapped_base;           // لقطة ثنائية مربوطة بالذاكرة (للقراءة فقط)، أو NULL
+    size_t mapped_size;
     Position start_position;
     Position exit_position;
 } Map3D;
@@ -32,6 +113,7 @@ typedef struct {
     int map_depth;
     float obstacle_ratio;
     float survivor_ratio;
+    MapLayout map_layout;        // MAP_LAYOUT = linear | morton
     
     int num_robots;
     Position robot_start;
@@ -51,13 +133,22 @@ typedef struct {
     int num_workers;
     int max_path_length;
     int log_level;
+    unsigned long long seed;     // بذرة المولد العشوائي (0 = من الوقت)
     char output_file[256];
 } Settings;
 
 // الدوال الرئيسية
 Map3D *create_map(int width, int height, int depth);
+Map3D *create_map_with_layout(int width, int height, int depth, MapLayout layout);
+void map_set_geometry(Map3D *map, int width, int height, int depth, MapLayout layout);
+void map_bump_serial(Map3D *map);
+Map3D *create_sparse_map(int width, int height, int depth);
 void initialize_map(Map3D *map, float obstacle_ratio, float survivor_ratio);
 void free_map(Map3D *map);
+void map_build_derived_data(Map3D *map);
+// يُستدعى قبل initialize_map؛ بعدها يعيد بناء البيانات المعتمدة على نقطة البداية
+bool map_set_start_position(Map3D *map, Position start);
+void map_release_buffer(const Map3D *map, void *ptr);
 Settings *load_settings(const char *filename);
 void print_settings(const Settings *settings);
 bool is_valid_position(const Map3D *map, Position pos);
@@ -68,10 +159,133 @@ void print_map(const Map3D *map);
 void save_map_to_file(const Map3D *map, const char *filename);
 void save_report_to_file(const Map3D *map);
 
+// ============= الوصول إلى الخلايا =============
+// توزيع 3 بتات على المواقع 0,3,6
+static inline size_t map_morton_dilate(size_t v)
+{
+    return (v & 1u) | ((v & 2u) << 2) | ((v & 4u) << 4);
+}
+
+// عكس map_morton_dilate
+static inline size_t map_morton_compact(size_t v)
+{
+    return (v & 1u) | ((v >> 2) & 2u) | ((v >> 4) & 4u);
+}
+
+// px, py, pz إحداثيات تشمل الإطار
+static inline size_t map_morton_index(const Map3D *map, size_t px, size_t py, size_t pz)
+{
+    const size_t mask = (1u << MAP_MORTON_SHIFT) - 1;
+    size_t block = ((pz >> MAP_MORTON_SHIFT) * map->blocks_y + (py >> MAP_MORTON_SHIFT)) * map->blocks_x +
+                   (px >> MAP_MORTON_SHIFT);
+    return (block << MAP_MORTON_BITS) | map_morton_dilate(px & mask) |
+           (map_morton_dilate(py & mask) << 1) | (map_morton_dilate(pz & mask) << 2);
+}
+
+// الفهرس داخل الشبكة المحاطة بالإطار؛ خطياً:
+// origin + x + stride_y * y + stride_z * z
+static inline size_t map_index(const Map3D *map, int x, int y, int z)
+{
+    if (map->layout == MAP_LAYOUT_MORTON)
+        return map_morton_index(map, (size_t)(x + MAP_PAD), (size_t)(y + MAP_PAD), (size_t)(z + MAP_PAD));
+    return map->origin + (size_t)z * map->stride_z + (size_t)y * map->stride_y + (size_t)x;
+}
+
+// فهرس الخلية المجاورة في اتجاه move دون فك الإحداثيات. في ترتيب
+// Morton تُزاد بتات المحور المبعثرة مباشرة، وعند تجاوز حد الكتلة
+// يُنتقل إلى الكتلة المجاورة بـ move_delta.
+static inline size_t map_step(const Map3D *map, size_t idx, int move)
+{
+    if (map->layout == MAP_LAYOUT_LINEAR || move >= 6)
+        return idx + map->move_delta[move];
+
+    size_t mask = (size_t)MAP_MORTON_X << (move >> 1);
+    size_t bits = idx & mask;
+    if (!(move & 1)) {
+        if (bits == mask) return (idx & ~mask) + map->move_delta[move];
+        return (idx & ~mask) | (((bits | ~mask) + 1) & mask);
+    }
+    if (bits == 0) return (idx | mask) + map->move_delta[move];
+    return (idx & ~mask) | ((bits - 1) & mask);
+}
+
+static inline size_t map_pos_index(const Map3D *map, Position pos)
+{
+    return map_index(map, pos.x, pos.y, pos.z);
+}
+
+uint8_t map_brick_cell_at(const Map3D *map, size_t idx);
+
+static inline uint8_t map_cell_at(const Map3D *map, size_t idx)
+{
+    if (map->cells) return map->cells[idx];
+    return map_brick_cell_at(map, idx);
+}
+
+// ============= خرائط البتات =============
+static inline bool map_bit_test(const uint64_t *bits, size_t idx)
+{
+    return (bits[idx >> 6] >> (idx & 63)) & 1u;
+}
+
+// 64 بت متتالية تبدأ من البت first (يوجد دائماً كلمة حشو في النهاية)
+static inline uint64_t map_bits_window(const uint64_t *bits, size_t first)
+{
+    size_t word = first >> 6;
+    unsigned shift = (unsigned)(first & 63);
+    uint64_t value = bits[word] >> shift;
+    if (shift) value |= bits[word + 1] << (64 - shift);
+    return value;
+}
+
+// عائق أو إطار: الخلية تحجب الحركة
+static inline bool map_is_obstacle_at(const Map3D *map, size_t idx)
+{
+    if (map->obstacle_bits) return map_bit_test(map->obstacle_bits, idx);
+    return map_cell_at(map, idx) & 1u;
+}
+
+static inline bool map_has_survivor_at(const Map3D *map, size_t idx)
+{
+    if (map->survivor_bits) return map_bit_test(map->survivor_bits, idx);
+    return map_cell_at(map, idx) == CELL_SURVIVOR;
+}
+
+// قناع الجيران الستة المحجوبين: البت رقم d مضبوط إذا كانت الحركة d
+// (بنفس ترتيب Direction) تخرج من الخريطة أو تصطدم بعائق
+// (أو بناجٍ إذا كان include_survivors صحيحاً). البت 6 يخص الخلية نفسها.
+unsigned map_blocked_neighbors(const Map3D *map, Position pos, bool include_survivors);
+size_t map_count_bits(const uint64_t *bits, size_t first, size_t count);
+// عدد خلايا النوع type في الطوابق [z_first, z_first + z_count) لأي نوع تخزين
+size_t map_count_cells(const Map3D *map, int z_first, int z_count, uint8_t type);
+
+// ============= فهرس الناجين =============
+// يُبنى مرة واحدة بعد توزيع الناجين (initialize_map)
+void map_build_survivor_index(Map3D *map);
+int map_lookup_survivor_slot(const Map3D *map, size_t idx);
+
+// رقم الناجي في الخلية idx أو -1، بزمن O(1)
+static inline int map_survivor_id_at(const Map3D *map, size_t idx)
+{
+    if (!map_has_survivor_at(map, idx))
+        return -1;
+    if (map->survivor_ids)
+        return map->survivor_ids[idx];
+    return map_lookup_survivor_slot(map, idx);
+}
+
+Position map_index_to_position(const Map3D *map, size_t idx);
+uint8_t map_get_cell(const Map3D *map, Position pos);
+void map_set_cell(Map3D *map, Position pos, uint8_t type);
+void map_set_cell_at(Map3D *map, size_t idx, uint8_t type);
+void map_rebuild_bitmaps(Map3D *map);
+
 // الدوال المساعدة
 float calculate_risk_from_priority(int priority);
-int calculate_unique_priority(Map3D *map, Position pos, float base_rubble_density);
-int count_nearby_rubble(Map3D *map, Position pos);
+// الأولوية 1..10 من كثافة الركام حول pos مقارنة بالكثافة العامة (5 = مساوية لها)
+int calculate_unique_priority(const Map3D *map, Position pos, float base_rubble_density);
+// عدد العوائق في الصندوق 5×5×5 حول pos
+int count_nearby_rubble(const Map3D *map, Position pos);
 
 Position random_position(const Map3D *map);
 Position random_near_position(Position center, const Map3D *map, int radius);
@@ -0,0 +1,20 @@
+#ifndef MAP_VOLUME_H
+#define MAP_VOLUME_H
+
+#include "map_loader.h"
+
+// ============= جدول المجاميع الحجمية للركام =============
+// S[z][y][x] = عدد العوائق في [0,x)×[0,y)×[0,z)، بحجم (w+1)(h+1)(d+1)
+// وبترتيب خطي مستقل عن ترتيب الخلايا. عدد الركام في أي صندوق بثماني قراءات.
+#define RUBBLE_QUERY_RADIUS 2    // "قريب" = الصندوق 5×5×5 حول الخلية
+
+bool map_build_rubble_sums(Map3D *map);
+size_t map_rubble_sums_length(const Map3D *map);
+
+// عدد العوائق في الصندوق [x0,x1]×[y0,y1]×[z0,z1] (شامل، يُقص على حدود الخريطة)
+size_t map_count_rubble_box(const Map3D *map, int x0, int y0, int z0, int x1, int y1, int z1);
+
+// عدد خلايا الصندوق بعد قصه على حدود الخريطة
+size_t map_box_cells(const Map3D *map, int x0, int y0, int z0, int x1, int y1, int z1);
+
+#endif // MAP_VOLUME_H
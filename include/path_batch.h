@@ -0,0 +1,38 @@
+#ifndef PATH_BATCH_H
+#define PATH_BATCH_H
+
+#include "path_eval.h"
+
+// ============= التقييم الدفعي (SIMD) =============
+// تتقدم EVAL_BATCH_LANES مسارات معاً حركةً بحركة: الجينات تُنقل إلى ترتيب
+// الحركة، ثم يُحسب الموضع والحدود والركام والخطر والطول لكل المسارات
+// بتعليمة واحدة. الخلايا والناجون المختلفون يُعدّون بعدها لكل مسار.
+#define EVAL_BATCH_LANES 8
+
+typedef enum {
+    EVAL_BATCH_SCALAR = 0,       // evaluate_path لكل مسار
+    EVAL_BATCH_SSE4 = 1,         // 4 مسارات في كل تعليمة
+    EVAL_BATCH_AVX2 = 2,         // 8 مسارات مع gather
+    EVAL_BATCH_AUTO = 3          // AVX2 إن دعمه المعالج، وإلا العادي
+} EvalBatchKernel;
+
+// يُختار تلقائياً عند أول استدعاء؛ false إذا كان المعالج لا يدعمه
+bool eval_batch_select(EvalBatchKernel kernel);
+EvalBatchKernel eval_batch_kernel(void);
+bool eval_batch_kernel_supported(EvalBatchKernel kernel);
+const char *eval_batch_kernel_name(EvalBatchKernel kernel);
+
+// الخرائط الكثيفة بالترتيب الخطي فقط؛ غيرها يُقيّم مساراً مساراً
+bool eval_batch_map_supported(const Map3D *map);
+
+// count مساراً: جينات المسار k عند genes + k * stride
+bool evaluate_paths_batch(const Gene *genes, size_t stride, const int *num_moves,
+                          const Position *starts, int count,
+                          const Map3D *map, EvalWorkspace *ws,
+                          float w_survivors, float w_coverage,
+                          float w_length, float w_risk, PathMetrics *out);
+
+// يقارن كل نواة مدعومة بـ evaluate_path على مسارات عشوائية؛ يعيد عدد الاختلافات
+int eval_batch_self_check(const Map3D *map, int paths, int max_moves);
+
+#endif // PATH_BATCH_H
@@ -0,0 +1,145 @@
+#ifndef PATH_EVAL_H
+#define PATH_EVAL_H
+
+#include "chromosome.h"
+
+// ============= نتائج تقييم مسار =============
+typedef struct {
+    float fitness;
+    int survivors_rescued;       // ناجون مرصودون (كل ناجٍ مرة واحدة)
+    int coverage_cells;          // خلايا مختلفة داخل الخريطة
+    float total_length;          // عدد الخطوات الفعلية (كل خطوة = 1)
+    float total_risk;            // مجموع خطر نقاط المسار
+    float time_estimate;
+    bool valid;                  // لا يدخل أي ركام أو حدود
+} PathMetrics;
+
+// ============= مساحة عمل التقييم =============
+// أختام بدل مصفوفات visited: الخلية مزورة إذا كان ختمها = رقم التقييم
+// الحالي، فلا حاجة لتصفير المخزن بين تقييم وآخر.
+// الخرائط المتفرقة أو الأكبر من EVAL_DENSE_STAMP_MAX_CELLS تستخدم جدول
+// تجزئة بحجم المسار بدل ختم لكل خلية (مساحة عمل لكل خيط).
+#define EVAL_DENSE_STAMP_MAX_CELLS ((size_t)1 << 24)
+#define EVAL_VISIT_MIN_SLOTS 1024
+
+typedef struct {
+    uint32_t *cell_stamp;        // ختم لكل خلية (cell_count)، أو NULL في وضع التجزئة
+    uint32_t *survivor_stamp;    // ختم لكل ناجٍ
+    size_t cell_capacity;
+    size_t *visit_cells;         // وضع التجزئة: عنونة مفتوحة، الخانة مشغولة إذا ختمها = epoch
+    uint32_t *visit_stamp;
+    size_t visit_mask;
+    size_t visit_count;          // خلايا التقييم الحالي في الجدول
+    int survivor_capacity;
+    uint32_t epoch;              // رقم التقييم الحالي
+    Gene *batch_genes;           // جينات دفعة بترتيب الحركة (انظر path_batch.h)
+    uint32_t *batch_cells;       // خلايا الدفعة بترتيب الموضع
+    int batch_capacity;          // عدد الحركات المحجوزة لكل مسار
+} EvalWorkspace;
+
+bool eval_workspace_reserve(EvalWorkspace *ws, const Map3D *map);
+void eval_workspace_release(EvalWorkspace *ws);
+
+bool eval_visit_grow(EvalWorkspace *ws, uint32_t epoch);
+
+// true عند أول زيارة للخلية في التقييم الحالي
+static inline bool eval_mark_cell(EvalWorkspace *ws, size_t idx, uint32_t epoch)
+{
+    if (ws->cell_stamp)
+    {
+        if (ws->cell_stamp[idx] == epoch) return false;
+        ws->cell_stamp[idx] = epoch;
+        return true;
+    }
+
+    size_t slot = (size_t)((idx * 0x9E3779B97F4A7C15ull) >> 32) & ws->visit_mask;
+    while (ws->visit_stamp[slot] == epoch)
+    {
+        if (ws->visit_cells[slot] == idx) return false;
+        slot = (slot + 1) & ws->visit_mask;
+    }
+    // A table that failed to grow keeps one empty slot; later cells count as seen
+    if (ws->visit_count >= ws->visit_mask) return false;
+
+    ws->visit_stamp[slot] = epoch;
+    ws->visit_cells[slot] = idx;
+    if (++ws->visit_count * 2 > ws->visit_mask + 1) eval_visit_grow(ws, epoch);
+    return true;
+}
+
+// مساحة العمل الخاصة بالخيط الحالي (تُحجز مرة وتُعاد)
+EvalWorkspace *eval_workspace_thread(const Map3D *map);
+
+// نواة التقييم: فك الترميز وحساب كل المقاييس في مرور واحد.
+// path اختياري (num_moves + 1 نقطة) ولا يُملأ إلا عند تمريره.
+bool evaluate_path(const Gene *moves, int num_moves, Position start,
+                   const Map3D *map, EvalWorkspace *ws,
+                   float w_survivors, float w_coverage,
+                   float w_length, float w_risk,
+                   PathMetrics *out, Position *path);
+
+// ============= التقييم التدريجي =============
+// نقطة حفظ كل EVAL_CHECKPOINT_INTERVAL حركة: حالة فك الترميز قبل الحركة
+#define EVAL_CHECKPOINT_INTERVAL 64
+
+typedef struct {
+    size_t idx;                  // الخلية الحالية
+    Position pos;
+    float risk;                  // المجاميع حتى هذه النقطة
+    int steps;
+    int coverage;                // = عدد العناصر الأولى من cells
+    int survivors;               // = عدد العناصر الأولى من survivors
+    bool valid;
+} EvalCheckpoint;
+
+// سجل تقييم كروموسوم: نقاط الحفظ، والخلايا والناجون بترتيب أول زيارة
+struct EvalTrace {
+    uint64_t map_serial;         // serial الخريطة، 0 = السجل غير صالح
+    Position start;
+    int num_moves;
+    EvalCheckpoint *checkpoints;
+    int checkpoint_count;
+    int checkpoint_capacity;
+    uint32_t *cells;
+    int cell_capacity;
+    int32_t *survivors;
+    int survivor_capacity;
+};
+
+void eval_trace_free(EvalTrace *trace);
+
+// السجل يخزن الخلايا بـ 32 بت؛ الخرائط الأكبر تُقيَّم كاملة دون سجل
+static inline bool eval_trace_map_supported(const Map3D *map)
+{
+    return map->cell_count <= (size_t)UINT32_MAX;
+}
+
+// ينسخ نقاط الحفظ التي لا تتجاوز الحركة moves (للأبناء الذين يشاركون البادئة)
+bool eval_trace_copy_prefix(EvalTrace **dst, const EvalTrace *src, int moves);
+
+// يستأنف من آخر نقطة حفظ قبل dirty_from ويحدّث السجل
+bool evaluate_path_incremental(const Gene *moves, int num_moves, Position start,
+                               const Map3D *map, EvalWorkspace *ws,
+                               EvalTrace *trace, int dirty_from,
+                               float w_survivors, float w_coverage,
+                               float w_length, float w_risk,
+                               PathMetrics *out);
+
+// ============= واجهة منخفضة المستوى (لطبقات التخزين المؤقت) =============
+// رقم ختم جديد: كل ما لم يُختم بعده يُعد غير مزور
+uint32_t eval_next_epoch(EvalWorkspace *ws);
+void eval_initial_state(const Map3D *map, Position start, int num_moves, EvalCheckpoint *state);
+bool eval_trace_reserve(EvalTrace *trace, int num_moves, int survivor_count);
+
+void eval_finish(const EvalCheckpoint *state,
+                 float w_survivors, float w_coverage,
+                 float w_length, float w_risk, PathMetrics *out);
+
+// يكمل المشي من الحركة first (يجب أن تكون العلامات السابقة مختومة بـ epoch)
+void eval_continue(const Gene *moves, int num_moves, int first,
+                   const Map3D *map, EvalWorkspace *ws, uint32_t epoch,
+                   EvalCheckpoint *state, EvalTrace *trace,
+                   float w_survivors, float w_coverage,
+                   float w_length, float w_risk, PathMetrics *out);
+
+#endif // PATH_EVAL_H
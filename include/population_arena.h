@@ -0,0 +1,92 @@
+#ifndef POPULATION_ARENA_H
+#define POPULATION_ARENA_H
+
+#include "chromosome.h"
+#include "path_eval.h"
+#include "fitness_cache.h"
+#include "prefix_cache.h"
+#include "path_batch.h"
+
+// ============= ساحة المجتمع =============
+// كل جينات المجتمع في مخزن واحد متصل بمسافة ثابتة (max_moves لكل فرد)،
+// ونتائج التقييم في مصفوفات متوازية. لا حجز للذاكرة بعد الإنشاء.
+typedef struct {
+    int size;                    // عدد الأفراد
+    int stride;                  // السعة القصوى لكل فرد (max_moves)
+    Gene *genes;                 // size * stride جين
+    int *num_moves;              // عدد الحركات الفعلية لكل فرد
+    Position *start_pos;         // نقطة البداية لكل فرد
+    int *ids;                    // المعرفات
+
+    // نتائج التقييم
+    float *fitness;
+    int *survivors_rescued;
+    int *coverage_cells;
+    float *total_length;
+    float *total_risk;
+    float *time_estimate;
+    bool *valid;
+} PopulationArena;
+
+// جيلان يتبادلان الدور: الحالي يُقرأ والتالي يُكتب
+typedef struct {
+    PopulationArena arenas[2];
+    int current;                 // رقم الساحة الحالية (0 أو 1)
+    int generation;              // رقم الجيل
+    EvalWorkspace *workspaces;   // مساحة تقييم لكل خيط
+    int workspace_count;
+} GenerationArenas;
+
+// ============= دوال الساحة =============
+bool population_arena_init(PopulationArena *arena, int size, int max_moves);
+void population_arena_release(PopulationArena *arena);
+
+static inline Gene *arena_genes(const PopulationArena *arena, int i)
+{
+    return arena->genes + (size_t)i * arena->stride;
+}
+
+// جينات عشوائية، تدفق مستقل لكل فرد (نتائج ثابتة مهما كان عدد الخيوط)
+void arena_randomize(PopulationArena *arena, Position start);
+
+// النخبة: نسخ فرد كامل مع نتائج تقييمه
+void arena_copy_individual(PopulationArena *dst, int d, const PopulationArena *src, int s);
+
+// التهجين من ساحة إلى أخرى، والطفرة في المكان
+void arena_crossover(Rng *rng, const PopulationArena *src, int p1, int p2,
+                     PopulationArena *dst, int c1, int c2, float crossover_rate);
+void arena_mutate(Rng *rng, PopulationArena *arena, int i, float mutation_rate);
+
+// تقييم الأفراد [first, first + count) بالتوازي (الذاكرتان اختياريتان)
+void arena_evaluate(PopulationArena *arena, int first, int count, const Map3D *map,
+                    EvalWorkspace *workspaces, int workspace_count,
+                    FitnessCache *cache, PrefixCache *prefixes,
+                    float w_survivors, float w_coverage,
+                    float w_length, float w_risk);
+
+// نفس التقييم دون ذاكرة: مجموعات من EVAL_BATCH_LANES فرداً بتعليمات SIMD
+void evaluate_population_batch(PopulationArena *arena, int first, int count, const Map3D *map,
+                               EvalWorkspace *workspaces, int workspace_count,
+                               float w_survivors, float w_coverage,
+                               float w_length, float w_risk);
+
+// التحويل من وإلى الكروموسومات العادية (للعرض والحفظ)
+void arena_store_chromosome(PopulationArena *arena, int i, const Chromosome *chrom);
+void arena_load_chromosome(const PopulationArena *arena, int i, Chromosome *chrom);
+
+// ============= الجيلان المتبادلان =============
+GenerationArenas* create_generation_arenas(int size, int max_moves, const Map3D *map);
+void free_generation_arenas(GenerationArenas *gens);
+void generation_arenas_swap(GenerationArenas *gens);
+
+static inline PopulationArena *generation_current(GenerationArenas *gens)
+{
+    return &gens->arenas[gens->current];
+}
+
+static inline PopulationArena *generation_next(GenerationArenas *gens)
+{
+    return &gens->arenas[gens->current ^ 1];
+}
+
+#endif // POPULATION_ARENA_H
@@ -0,0 +1,39 @@
+#ifndef PREFIX_CACHE_H
+#define PREFIX_CACHE_H
+
+#include "fitness_cache.h"
+
+// ============= ذاكرة البادئات المشتركة =============
+// كتل من PREFIX_BLOCK_MOVES حركة: لكل بادئة (بصمة كل الجينات قبلها) تُحفظ
+// حالة فك الترميز عند نهايتها والخلايا/الناجون الجدد في آخر كتلة، مع
+// رابط للكتلة السابقة (شجرة بادئات). التقييم يستأنف من أطول بادئة محفوظة.
+#define PREFIX_BLOCK_MOVES EVAL_CHECKPOINT_INTERVAL
+#define PREFIX_CACHE_SHARDS 64
+
+typedef struct PrefixCache PrefixCache;
+
+typedef struct {
+    uint64_t paths;              // مسارات قُيّمت عبر الذاكرة
+    uint64_t moves_reused;       // حركات أُخذت من بادئات محفوظة
+    uint64_t moves_walked;       // حركات مُشيت فعلاً
+    int entries;                 // كتل محفوظة
+    int capacity;
+} PrefixCacheStats;
+
+// entries: عدد الكتل الأقصى (مثلاً حجم المجتمع × max_moves / 64)
+PrefixCache* prefix_cache_create(int entries, const Map3D *map);
+void prefix_cache_free(PrefixCache *cache);
+void prefix_cache_clear(PrefixCache *cache);
+
+// بداية جيل جديد: تُفرَّغ الذاكرة فقط إذا امتلأت
+void prefix_cache_begin_generation(PrefixCache *cache);
+
+bool evaluate_path_prefixed(const Gene *moves, int num_moves, Position start,
+                            const Map3D *map, EvalWorkspace *ws, PrefixCache *cache,
+                            float w_survivors, float w_coverage,
+                            float w_length, float w_risk, PathMetrics *out);
+
+void prefix_cache_get_stats(PrefixCache *cache, PrefixCacheStats *stats);
+void prefix_cache_print_stats(PrefixCache *cache);
+
+#endif // PREFIX_CACHE_H
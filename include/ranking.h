@@ -0,0 +1,24 @@
+#ifndef RANKING_H
+#define RANKING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============= مفتاح الترتيب =============
+// زوج (لياقة، فهرس) مضغوط: يُرتب بدل نقل هياكل الكروموسومات
+typedef struct {
+    float fitness;
+    int32_t index;
+} FitnessKey;
+
+// ترتيب جذري مستقر (4 تمريرات × 8 بت) على بتات اللياقة؛ scratch بنفس الحجم.
+// التساوي يحافظ على ترتيب الإدخال (الفهرس الأصغر أولاً عند ملء المفاتيح بالترتيب)
+void fitness_keys_radix_sort(FitnessKey *keys, FitnessKey *scratch, int count, bool descending);
+
+// أفضل k مفتاحاً بكومة صغرى محدودة O(n log k)؛ out مرتب من الأفضل ويعاد عدده
+int fitness_keys_top_k(const FitnessKey *keys, int count, int k, FitnessKey *out);
+
+// اختيار جزئي O(n) بأسلوب nth_element: order[0, k) أفضل k فهرساً دون ترتيب
+void fitness_select_top(const float *fitness, int count, int k, int32_t *order);
+
+#endif // RANKING_H
@@ -0,0 +1,87 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============= مولّد الأعداد العشوائية =============
+// xoshiro256** : حالة صغيرة لكل تدفق، بدون أقفال عامة مثل rand().
+// للحصول على نتائج متطابقة مهما كان عدد العمال، يُشتق كل تدفق من
+// (البذرة، رقم وحدة العمل) وليس من رقم الخيط.
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+// أرقام التدفقات المحجوزة لكل نوع من العمل
+#define RNG_STREAM_MAP        0x100000ULL   // + رقم الخريطة/الطابق
+#define RNG_STREAM_THREAD     0x200000ULL   // التدفق الافتراضي لكل خيط
+#define RNG_STREAM_POPULATION 0x300000ULL   // + رقم الفرد/الجيل
+
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream);
+
+// البذرة العامة (من SEED في ملف الإعدادات)
+void rng_set_global_seed(uint64_t seed);
+uint64_t rng_global_seed(void);
+
+// التدفق الافتراضي للخيط الحالي (للشيفرة التسلسلية فقط)
+Rng *rng_thread(void);
+
+static inline uint64_t rng_rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// خلط splitmix64 النهائي (يُستعمل أيضاً لبصمات الجينات)
+static inline uint64_t rng_mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static inline uint64_t rng_next(Rng *rng)
+{
+    uint64_t *s = rng->s;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+
+    return result;
+}
+
+// عدد صحيح منتظم في [0, bound) بطريقة Lemire (بدون انحياز)
+static inline uint32_t rng_bounded(Rng *rng, uint32_t bound)
+{
+    uint64_t m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+// عدد حقيقي منتظم في [0, 1)
+static inline float rng_float(Rng *rng)
+{
+    return (float)(rng_next(rng) >> 40) * (1.0f / 16777216.0f);
+}
+
+// توليد دفعات كاملة (للتهيئة والطفرات)
+void rng_fill_bounded(Rng *rng, uint32_t bound, uint32_t *out, size_t n);
+void rng_fill_bounded_u8(Rng *rng, uint8_t bound, uint8_t *out, size_t n);
+void rng_fill_float(Rng *rng, float *out, size_t n);
+
+#endif // RNG_H
@@ -0,0 +1,64 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include "chromosome.h"
+#include "ranking.h"
+
+// ============= جدول Alias (Walker/Vose) =============
+// سحب عنصر باحتمال يتناسب مع وزنه في O(1) بعد بناء O(n) مرة واحدة
+typedef struct {
+    int size;
+    int capacity;
+    float *prob;                 // احتمال البقاء في الخانة نفسها
+    int32_t *alias;              // الخانة البديلة
+    int32_t *scratch;            // قائمتا الصغير/الكبير أثناء البناء
+} AliasTable;
+
+// الأوزان غير سالبة؛ إذا كان مجموعها صفراً يصبح السحب منتظماً
+bool alias_table_build(AliasTable *table, const float *weights, int count);
+void alias_table_release(AliasTable *table);
+
+// سحبة 64 بت واحدة: 32 بتاً عليا للخانة و 24 بتاً دنيا للاحتمال
+static inline int alias_table_sample(const AliasTable *table, Rng *rng)
+{
+    uint64_t r = rng_next(rng);
+    int slot = (int)(((r >> 32) * (uint64_t)table->size) >> 32);
+    float u = (float)(r & 0xFFFFFFu) * (1.0f / 16777216.0f);
+    return u < table->prob[slot] ? slot : table->alias[slot];
+}
+
+// ============= البطولة بالفهارس =============
+// أفضل k فهرساً عشوائياً؛ لا يقرأ إلا مصفوفة اللياقة
+static inline int tournament_select_index(Rng *rng, const float *fitness, int size, int k)
+{
+    int best = (int)rng_bounded(rng, (uint32_t)size);
+    for (int t = 1; t < k; t++)
+    {
+        int c = (int)rng_bounded(rng, (uint32_t)size);
+        if (fitness[c] > fitness[best]) best = c;
+    }
+    return best;
+}
+
+// ============= جداول الانتقاء لكل جيل =============
+// ضغط الانتقاء الخطي بالرتبة: 1 = منتظم، 2 = الأسوأ لا يُختار أبداً
+#define RANK_SELECTION_PRESSURE 1.5f
+
+struct SelectionTables {
+    int generation;              // الجيل الذي بُنيت له (-1 = غير صالحة)
+    int size;
+    int capacity;
+    float *fitness;              // نسخة متصلة من اللياقة (البطولة)
+    FitnessKey *ranked;          // الأفراد من الأسوأ إلى الأفضل
+    FitnessKey *scratch;         // مخزن الترتيب الجذري
+    float *weights;              // مخزن مؤقت للأوزان
+    AliasTable roulette;         // الوزن = اللياقة - أدنى لياقة
+    AliasTable rank;             // أوزان الرتب (تعتمد على الحجم فقط)
+    int rank_size;               // الحجم الذي بُني له جدول الرتب
+};
+
+// يُستدعى مرة بعد تقييم كل جيل. بدونه تعمل دوال الانتقاء بمسح خطي O(n)
+bool prepare_selection(Population *pop);
+void selection_tables_free(SelectionTables *tables);
+
+#endif // SELECTION_H
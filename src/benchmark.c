@@ -0,0 +1,1222 @@
+#include "benchmark.h"
+#include "map_io.h"
+#include "map_bricks.h"
+#include "map_components.h"
+#include "map_fields.h"
+#include "map_distance.h"
+#include "chromosome.h"
+#include "population_arena.h"
+#include "path_eval.h"
+#include "fitness_cache.h"
+#include "prefix_cache.h"
+#include "path_batch.h"
+#include "selection.h"
+#include "ranking.h"
+#include "rng.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double file_size_mb(const char *filename)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file) return 0.0;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size / (1024.0 * 1024.0);
+}
+
+// ============================================================
+// TEXT MAP INGESTION
+// ============================================================
+
+// Lower bound: just pull the bytes through in the loader's block size
+static bool bench_read_only(const char *filename)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file) return false;
+
+    char *buffer = (char *)malloc(MAP_TEXT_BLOCK_SIZE);
+    size_t checksum = 0;
+    size_t got;
+    while (buffer && (got = fread(buffer, 1, MAP_TEXT_BLOCK_SIZE, file)) > 0)
+        checksum += (unsigned char)buffer[got - 1];
+
+    free(buffer);
+    fclose(file);
+    return checksum != (size_t)-1;
+}
+
+// Reference: the straightforward fgets + sscanf reader, parse only
+static Map3D *bench_load_with_sscanf(const char *filename)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file) return NULL;
+
+    char line[256];
+    int width = 0, height = 0, depth = 0;
+    Map3D *map = NULL;
+    int capacity = 0;
+
+    while (fgets(line, sizeof(line), file))
+    {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        if (sscanf(line, "WIDTH=%d", &width) == 1) continue;
+        if (sscanf(line, "HEIGHT=%d", &height) == 1) continue;
+        if (sscanf(line, "DEPTH=%d", &depth) == 1) continue;
+
+        Position pos;
+        int type;
+        Survivor s;
+        memset(&s, 0, sizeof(s));
+        int fields = sscanf(line, "%d,%d,%d,%d,%d,%f,%f,%d", &pos.x, &pos.y, &pos.z, &type,
+                            &s.priority, &s.heat_signal, &s.co2_level, &s.sensor_confidence);
+        if (fields < 4) continue;
+
+        if (!map)
+        {
+            map = create_map(width, height, depth);
+            if (!map) break;
+        }
+        if (!is_valid_position(map, pos)) continue;
+
+        map_set_cell(map, pos, (uint8_t)type);
+        if (type == CELL_SURVIVOR)
+        {
+            if (map->survivor_count == capacity)
+            {
+                capacity = capacity ? capacity * 2 : 64;
+                map->survivors = (Survivor *)realloc(map->survivors, capacity * sizeof(Survivor));
+            }
+            s.pos = pos;
+            map->survivors[map->survivor_count++] = s;
+        }
+    }
+
+    fclose(file);
+    return map;
+}
+
+// Loaders report progress on stdout; keep that out of the timed region
+static int bench_mute_stdout(void)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved >= 0 && null_fd >= 0) dup2(null_fd, STDOUT_FILENO);
+    if (null_fd >= 0) close(null_fd);
+    return saved;
+}
+
+static void bench_restore_stdout(int saved)
+{
+    fflush(stdout);
+    if (saved < 0) return;
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+// A scan-sized file in the save_map_to_file format, one line per cell:
+// about 35 MB, so per-call overheads do not hide the parser
+static bool bench_write_text_map(const char *filename, int width, int height, int depth)
+{
+    FILE *file = fopen(filename, "w");
+    if (!file) return false;
+
+    fprintf(file, "# Synthetic scan for the ingestion benchmark\n");
+    fprintf(file, "WIDTH=%d\nHEIGHT=%d\nDEPTH=%d\n", width, height, depth);
+    for (int z = 0; z < depth; z++)
+    {
+        fprintf(file, "# Floor %d data\n", z);
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+            {
+                // ~30% rubble and a handful of survivors (each one adds a
+                // BFS field to the derived data build). A hash of the cell
+                // keeps the file identical from run to run.
+                uint64_t h = ((uint64_t)z * height + y) * width + x;
+                h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCDULL;
+                h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+                uint32_t r = (uint32_t)((h ^ (h >> 33)) % 1000000);
+                if (r < 1)
+                    fprintf(file, "%d,%d,%d,2,5,36.5,400,80,normal\n", x, y, z);
+                else
+                    fprintf(file, "%d,%d,%d,%d\n", x, y, z, r < 300000 ? CELL_OBSTACLE : CELL_FREE);
+            }
+    }
+
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+void benchmark_text_map_loader(const char *filename)
+{
+    if (!filename) return;
+
+    printf("\n📄 Text map ingestion benchmark\n");
+    printf("------------------------------------------\n");
+
+    const int width = BENCH_TEXT_SIDE, height = BENCH_TEXT_SIDE, depth = BENCH_TEXT_DEPTH;
+    double mb = bench_write_text_map(filename, width, height, depth) ? file_size_mb(filename) : 0.0;
+    if (mb <= 0.0)
+    {
+        printf("❌ Could not write '%s'\n", filename);
+        return;
+    }
+
+    double best_read = 1e30, best_fast = 1e30, best_sscanf = 1e30, best_derived = 1e30;
+
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        int saved = bench_mute_stdout();
+        double t0 = bench_now();
+        bench_read_only(filename);
+        double t1 = bench_now();
+        Map3D *fast = load_map_cells_from_text(filename);
+        double t2 = bench_now();
+        Map3D *slow = bench_load_with_sscanf(filename);
+        double t3 = bench_now();
+
+        // load_map_from_text adds this build after the parse
+        if (fast) map_build_derived_data(fast);
+        double derived = bench_now() - t3;
+        bench_restore_stdout(saved);
+
+        if (!fast || !slow)
+            printf("❌ A loader failed on '%s'\n", filename);
+        else if (fast->cells && slow->cells && memcmp(fast->cells, slow->cells, fast->cell_count) != 0)
+            printf("⚠️  Streaming loader and sscanf loader disagree!\n");
+
+        free_map(fast);
+        free_map(slow);
+
+        if (derived < best_derived) best_derived = derived;
+        if (t1 - t0 < best_read) best_read = t1 - t0;
+        if (t2 - t1 < best_fast) best_fast = t2 - t1;
+        if (t3 - t2 < best_sscanf) best_sscanf = t3 - t2;
+    }
+    remove(filename);
+
+    printf("\n File size:            %.1f MB (%d × %d × %d cells)\n", mb, width, height, depth);
+    printf(" Raw block read:       %8.3f s  %8.1f MB/s\n", best_read, mb / best_read);
+    printf(" Streaming parser:     %8.3f s  %8.1f MB/s\n", best_fast, mb / best_fast);
+    printf(" fgets + sscanf:       %8.3f s  %8.1f MB/s (x%.1f slower)\n",
+           best_sscanf, mb / best_sscanf, best_sscanf / best_fast);
+    printf(" Derived data build:   %8.3f s  (after either parser)\n", best_derived);
+}
+
+// ============================================================
+// SPARSE BRICK STORAGE
+// ============================================================
+
+static Map3D *bench_sparse_copy(const Map3D *map)
+{
+    Map3D *sparse = create_sparse_map(map->width, map->height, map->depth);
+    if (!sparse) return NULL;
+
+    // Copy by coordinates: the source may use a different cell layout
+    for (int z = 0; z < map->depth; z++)
+        for (int y = 0; y < map->height; y++)
+            for (int x = 0; x < map->width; x++)
+                map_set_cell_at(sparse, map_index(sparse, x, y, z), map_cell_at(map, map_index(map, x, y, z)));
+    map_compact_bricks(sparse, 0, sparse->bricks->bricks_z);
+    return sparse;
+}
+
+// Mostly-uniform building: solid rubble up to a rough collapse surface,
+// open void above it
+static Map3D *bench_layered_building(int width, int height, int depth, Rng *rng)
+{
+    Map3D *sparse = create_sparse_map(width, height, depth);
+    if (!sparse) return NULL;
+
+    int base = depth / 3;
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+        {
+            int top = base + (int)rng_bounded(rng, 5) - 2;
+            for (int z = 0; z < top; z++)
+                map_set_cell_at(sparse, map_index(sparse, x, y, z), CELL_OBSTACLE);
+        }
+    map_compact_bricks(sparse, 0, sparse->bricks->bricks_z);
+    return sparse;
+}
+
+static double bench_random_reads(const Map3D *map, const uint32_t *picks, int count, size_t *checksum)
+{
+    double t0 = bench_now();
+    size_t sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += map_cell_at(map, picks[i]);
+    *checksum = sum;
+    return bench_now() - t0;
+}
+
+void benchmark_sparse_storage(const Map3D *map)
+{
+    if (!map || map->bricks || map->cell_count > UINT32_MAX) return;
+
+    printf("\n🧊 Sparse brick storage benchmark\n");
+    printf("------------------------------------------\n");
+
+    Rng rng;
+    rng_seed(&rng, rng_global_seed(), RNG_STREAM_THREAD - 1);
+
+    Map3D *sparse = bench_sparse_copy(map);
+    if (!sparse)
+    {
+        printf("❌ Could not build the sparse copy\n");
+        return;
+    }
+
+    size_t mismatches = 0;
+    for (int z = 0; z < map->depth; z++)
+        for (int y = 0; y < map->height; y++)
+            for (int x = 0; x < map->width; x++)
+                mismatches += map_cell_at(map, map_index(map, x, y, z)) !=
+                              map_cell_at(sparse, map_index(sparse, x, y, z));
+
+    // The same random cells, addressed in each map's own index space
+    enum { READS = 1 << 22 };
+    uint32_t *picks = (uint32_t *)malloc(READS * sizeof(uint32_t));
+    uint32_t *sparse_picks = (uint32_t *)malloc(READS * sizeof(uint32_t));
+    if (!picks || !sparse_picks)
+    {
+        free(picks);
+        free(sparse_picks);
+        free_map(sparse);
+        return;
+    }
+    rng_fill_bounded(&rng, (uint32_t)map->cell_count, picks, READS);
+    for (int i = 0; i < READS; i++)
+    {
+        Position pos = map_index_to_position(map, picks[i]);
+        if (!is_valid_position(map, pos)) pos = map->start_position;
+        picks[i] = (uint32_t)map_pos_index(map, pos);
+        sparse_picks[i] = (uint32_t)map_pos_index(sparse, pos);
+    }
+
+    double best_dense = 1e30, best_sparse = 1e30;
+    size_t dense_sum = 0, sparse_sum = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        double t = bench_random_reads(map, picks, READS, &dense_sum);
+        if (t < best_dense) best_dense = t;
+        t = bench_random_reads(sparse, sparse_picks, READS, &sparse_sum);
+        if (t < best_sparse) best_sparse = t;
+    }
+    free(picks);
+    free(sparse_picks);
+
+    printf(" Current map:          %zu of %zu bricks allocated\n",
+           sparse->bricks->allocated, sparse->bricks->brick_count);
+    printf("   Dense storage:      %8.2f MB\n", map_storage_bytes(map) / (1024.0 * 1024.0));
+    printf("   Brick storage:      %8.2f MB  %s\n", map_storage_bytes(sparse) / (1024.0 * 1024.0),
+           mismatches == 0 && dense_sum == sparse_sum ? "(cells identical)" : "⚠️  CELLS DIFFER");
+    printf("   Random reads:       %6.1f ns dense, %6.1f ns bricks\n",
+           best_dense * 1e9 / READS, best_sparse * 1e9 / READS);
+    free_map(sparse);
+
+    // Uniform regions dominate real collapses; random rubble is the worst case
+    Map3D *layered = bench_layered_building(512, 512, 96, &rng);
+    if (layered)
+    {
+        printf(" Layered 512×512×96:   %zu of %zu bricks allocated\n",
+               layered->bricks->allocated, layered->bricks->brick_count);
+        // Cells plus the two bitmaps a dense map keeps
+        size_t dense_bytes = layered->cell_count + 2 * ((layered->cell_count + 63) / 64 + 1) * sizeof(uint64_t);
+        printf("   Dense storage:      %8.2f MB\n", dense_bytes / (1024.0 * 1024.0));
+        printf("   Brick storage:      %8.2f MB\n", map_storage_bytes(layered) / (1024.0 * 1024.0));
+        free_map(layered);
+    }
+}
+
+// ============================================================
+// CONNECTED COMPONENTS
+// ============================================================
+void benchmark_components(const Map3D *map)
+{
+    if (!map) return;
+
+    printf("\n🧭 Free-space component labelling benchmark\n");
+    printf("------------------------------------------\n");
+
+    // Label a private copy of the header so the map's own results stay put
+    Map3D scratch = *map;
+    scratch.survivor_reachable = NULL;
+
+    double best = 1e30;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        double t0 = bench_now();
+        bool ok = map_label_components(&scratch);
+        double t = bench_now() - t0;
+        free(scratch.survivor_reachable);
+        scratch.survivor_reachable = NULL;
+        if (!ok) return;
+        if (t < best) best = t;
+    }
+
+    printf(" Cells:                %zu (%llu components)\n", map->volume,
+           (unsigned long long)scratch.components.component_count);
+    printf(" Labelling:            %8.4f s  %8.1f Mvoxel/s\n", best, map->volume / best * 1e-6);
+}
+
+// ============================================================
+// CELL LAYOUT (LINEAR VS MORTON)
+// ============================================================
+
+// Lookup tables used by path evaluation, without the distance fields
+static void bench_build_walk_tables(Map3D *map)
+{
+    map_build_survivor_index(map);
+    map_label_components(map);
+    map_build_risk_field(map);
+    map_build_detection_lists(map);
+}
+
+static Map3D *bench_layout_copy(const Map3D *map, MapLayout layout)
+{
+    Map3D *copy = create_map_with_layout(map->width, map->height, map->depth, layout);
+    if (!copy) return NULL;
+
+    for (int z = 0; z < map->depth; z++)
+        for (int y = 0; y < map->height; y++)
+            for (int x = 0; x < map->width; x++)
+                map_set_cell_at(copy, map_index(copy, x, y, z), map_cell_at(map, map_index(map, x, y, z)));
+
+    copy->survivors = (Survivor *)malloc(((size_t)map->survivor_count + 1) * sizeof(Survivor));
+    if (!copy->survivors)
+    {
+        free_map(copy);
+        return NULL;
+    }
+    memcpy(copy->survivors, map->survivors, (size_t)map->survivor_count * sizeof(Survivor));
+    copy->survivor_count = map->survivor_count;
+    copy->start_position = map->start_position;
+    copy->exit_position = map->exit_position;
+
+    bench_build_walk_tables(copy);
+    return copy;
+}
+
+// 30% rubble, 0.2% survivors; identical content for every layout
+static Map3D *bench_random_building(int width, int height, int depth, MapLayout layout)
+{
+    Map3D *map = create_map_with_layout(width, height, depth, layout);
+    if (!map) return NULL;
+
+    size_t capacity = map->volume / 256 + 1;
+    map->survivors = (Survivor *)calloc(capacity, sizeof(Survivor));
+    if (!map->survivors)
+    {
+        free_map(map);
+        return NULL;
+    }
+
+    Rng rng;
+    rng_seed(&rng, rng_global_seed(), RNG_STREAM_THREAD - 2);
+    for (int z = 0; z < depth; z++)
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+            {
+                uint32_t r = rng_bounded(&rng, 1000);
+                if ((x | y | z) == 0) continue;
+
+                if (r < 300)
+                    map_set_cell_at(map, map_index(map, x, y, z), CELL_OBSTACLE);
+                else if (r < 302 && (size_t)map->survivor_count < capacity)
+                {
+                    Survivor *s = &map->survivors[map->survivor_count++];
+                    s->pos = (Position){x, y, z};
+                    s->priority = 5;
+                    map_set_cell_at(map, map_index(map, x, y, z), CELL_SURVIVOR);
+                }
+            }
+
+    bench_build_walk_tables(map);
+    return map;
+}
+
+typedef struct {
+    double walk, risk_scan, survivor_scan, bfs;
+    double checksum;
+} LayoutTimes;
+
+// Path walks and the neighbourhood scans along them, plus one BFS
+static void bench_layout_run(const Map3D *map, Chromosome **walks, int walk_count, LayoutTimes *out)
+{
+    out->walk = out->risk_scan = out->survivor_scan = out->bfs = 1e30;
+    uint16_t *field = (uint16_t *)malloc(map->cell_count * sizeof(uint16_t));
+
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        double checksum = 0.0;
+
+        // Decode, then the per-step risk and survivor lookups
+        double t0 = bench_now();
+        for (int i = 0; i < walk_count; i++)
+        {
+            Chromosome *chrom = walks[i];
+            free(chrom->actual_path);
+            chrom->actual_path = decode_chromosome_with_bounds(chrom, &chrom->actual_path_length, map);
+            checksum += calculate_path_risk(chrom, map) + count_survivors_on_path(chrom, map);
+        }
+        double t1 = bench_now();
+
+        // 5x5x5 obstacle window around every step
+        for (int i = 0; i < walk_count; i++)
+            for (int k = 0; k < walks[i]->actual_path_length; k++)
+                checksum += map_compute_cell_risk(map, map_pos_index(map, walks[i]->actual_path[k]));
+        double t2 = bench_now();
+
+        // 3x3x3 survivor window around every step
+        for (int i = 0; i < walk_count; i++)
+            for (int k = 0; k < walks[i]->actual_path_length; k++)
+            {
+                int n;
+                map_scan_detectable_survivors(map, map_pos_index(map, walks[i]->actual_path[k]), &n);
+                checksum += n;
+            }
+        double t3 = bench_now();
+
+        size_t source = map_pos_index(map, map->start_position);
+        if (field) map_bfs_distance(map, &source, 1, field);
+        double t4 = bench_now();
+
+        if (t1 - t0 < out->walk) out->walk = t1 - t0;
+        if (t2 - t1 < out->risk_scan) out->risk_scan = t2 - t1;
+        if (t3 - t2 < out->survivor_scan) out->survivor_scan = t3 - t2;
+        if (t4 - t3 < out->bfs) out->bfs = t4 - t3;
+        out->checksum = checksum;
+    }
+
+    free(field);
+}
+
+static void bench_layout_compare(const char *label, Map3D *linear, Map3D *morton)
+{
+    enum { WALKS = 64, WALK_STEPS = 2000 };
+    Chromosome *walks[WALKS];
+    int walk_count = 0;
+
+    // Free-space random walks, generated once and replayed on both layouts
+    for (int i = 0; i < WALKS; i++)
+    {
+        walks[walk_count] = generate_smart_chromosome(linear->start_position, WALK_STEPS, linear);
+        if (walks[walk_count]) walk_count++;
+    }
+
+    LayoutTimes a, b;
+    bench_layout_run(linear, walks, walk_count, &a);
+    bench_layout_run(morton, walks, walk_count, &b);
+
+    for (int i = 0; i < walk_count; i++)
+        free_chromosome(walks[i]);
+
+    double steps = (double)walk_count * (WALK_STEPS + 1);
+    printf(" %s: %d × %d × %d, %d survivors%s\n", label,
+           linear->width, linear->height, linear->depth, linear->survivor_count,
+           fabs(a.checksum - b.checksum) <= 1e-3 * (fabs(a.checksum) + 1.0) ? "" : "  ⚠️  RESULTS DIFFER");
+    printf("                          linear      morton\n");
+    printf("   Index space:       %8.2f MB  %8.2f MB\n",
+           linear->cell_count / (1024.0 * 1024.0), morton->cell_count / (1024.0 * 1024.0));
+    printf("   Path walk:         %8.1f ns  %8.1f ns  per step\n", a.walk * 1e9 / steps, b.walk * 1e9 / steps);
+    printf("   5×5×5 risk scan:   %8.1f ns  %8.1f ns  per step\n",
+           a.risk_scan * 1e9 / steps, b.risk_scan * 1e9 / steps);
+    printf("   3×3×3 survivors:   %8.1f ns  %8.1f ns  per step\n",
+           a.survivor_scan * 1e9 / steps, b.survivor_scan * 1e9 / steps);
+    printf("   BFS from start:    %8.2f ms  %8.2f ms\n", a.bfs * 1e3, b.bfs * 1e3);
+}
+
+void benchmark_layouts(const Map3D *map)
+{
+    if (!map || map->bricks) return;
+
+    printf("\n🧮 Cell layout benchmark (linear vs Morton)\n");
+    printf("------------------------------------------\n");
+
+    Map3D *linear = bench_layout_copy(map, MAP_LAYOUT_LINEAR);
+    Map3D *morton = bench_layout_copy(map, MAP_LAYOUT_MORTON);
+    if (linear && morton) bench_layout_compare("Current map", linear, morton);
+    free_map(linear);
+    free_map(morton);
+
+    linear = bench_random_building(256, 256, 64, MAP_LAYOUT_LINEAR);
+    morton = bench_random_building(256, 256, 64, MAP_LAYOUT_MORTON);
+    if (linear && morton) bench_layout_compare("Large building", linear, morton);
+    free_map(linear);
+    free_map(morton);
+}
+
+// ============================================================
+// GENE STORAGE (4-BYTE ENUM VS BYTE VS 3-BIT)
+// ============================================================
+#define BENCH_GENE_PATHS 2000
+#define BENCH_GENE_MOVES 2000
+
+void benchmark_genes(void)
+{
+    printf("\n🧬 Gene storage benchmark (%d paths × %d moves)\n", BENCH_GENE_PATHS, BENCH_GENE_MOVES);
+    printf("------------------------------------------------\n");
+
+    const int n = BENCH_GENE_MOVES;
+    const size_t words = packed_gene_words(n);
+    Position start = {0, 0, 0};
+    Population *pop = create_initial_population(start, BENCH_GENE_PATHS, n, NULL);
+    Chromosome child1 = {0}, child2 = {0};
+    uint32_t *wide = malloc((size_t)BENCH_GENE_PATHS * n * sizeof(uint32_t));
+    uint32_t *wide_child = malloc((size_t)n * sizeof(uint32_t));
+    uint64_t *packed = malloc((size_t)BENCH_GENE_PATHS * words * sizeof(uint64_t));
+    uint64_t *packed_child = malloc(words * sizeof(uint64_t));
+    if (!pop || !wide || !wide_child || !packed || !packed_child)
+    {
+        printf("❌ Memory allocation error for gene benchmark\n");
+        goto done;
+    }
+
+    for (int p = 0; p < BENCH_GENE_PATHS; p++)
+    {
+        const Gene *genes = pop->individuals[p].moves;
+        for (int i = 0; i < n; i++) wide[(size_t)p * n + i] = genes[i];
+        pack_genes(genes, n, packed + (size_t)p * words);
+    }
+
+    // Same parent pairs and cut points for every storage mode
+    Rng rng;
+    int pairs = BENCH_GENE_PATHS / 2;
+    double t_wide = 1e30, t_byte = 1e30, t_packed = 1e30;
+    size_t checksum = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        rng_seed(&rng, 42, 0);
+        double t0 = bench_now();
+        for (int k = 0; k < pairs; k++)
+        {
+            const uint32_t *a = wide + (size_t)(2 * k) * n, *b = a + n;
+            int point = 1 + (int)rng_bounded(&rng, n - 1);
+            memcpy(wide_child, a, point * sizeof(uint32_t));
+            memcpy(wide_child + point, b + point, (n - point) * sizeof(uint32_t));
+            checksum += wide_child[point];
+        }
+        double t = bench_now() - t0;
+        if (t < t_wide) t_wide = t;
+
+        t0 = bench_now();
+        for (int k = 0; k < pairs; k++)
+            crossover_chromosomes(&pop->individuals[2 * k], &pop->individuals[2 * k + 1],
+                                  &child1, &child2, 1.0f);
+        t = bench_now() - t0;
+        if (t < t_byte) t_byte = t;
+
+        rng_seed(&rng, 42, 0);
+        t0 = bench_now();
+        for (int k = 0; k < pairs; k++)
+        {
+            const uint64_t *a = packed + (size_t)(2 * k) * words, *b = a + words;
+            int point = 1 + (int)rng_bounded(&rng, n - 1);
+            packed_genes_crossover(a, b, point, n, packed_child);
+            checksum += packed_child[point / GENES_PER_WORD] & 1;
+        }
+        t = bench_now() - t0;
+        if (t < t_packed) t_packed = t;
+    }
+
+    // Footprint of 10^5 paths of 2,000 moves
+    const double paths = 1e5, mb = 1024.0 * 1024.0;
+    printf(" Genes for 10^5 paths: enum %8.1f MB  byte %8.1f MB  3-bit %8.1f MB\n",
+           paths * n * sizeof(uint32_t) / mb, paths * n * sizeof(Gene) / mb,
+           paths * words * sizeof(uint64_t) / mb);
+    printf(" Crossover (1 child):  enum %8.2f µs  ", t_wide / pairs * 1e6);
+    printf("3-bit %8.2f µs\n", t_packed / pairs * 1e6);
+    printf(" Crossover (2 children, byte genes): %8.2f µs   (checksum %zu)\n",
+           t_byte / pairs * 1e6, checksum % 10);
+
+done:
+    free(child1.moves);
+    free(child2.moves);
+    free(wide);
+    free(wide_child);
+    free(packed);
+    free(packed_child);
+    free_population(pop);
+}
+
+// ============================================================
+// POPULATION ARENA (PER-INDIVIDUAL MALLOC VS DOUBLE BUFFER)
+// ============================================================
+#define BENCH_ARENA_SIZE 1000
+#define BENCH_ARENA_MOVES 1000
+#define BENCH_ARENA_GENERATIONS 5
+
+// Elitism, crossover and mutation with the Chromosome API: every child
+// allocates its own buffers
+static Population *bench_heap_breed(Population *pop, const Map3D *map, Rng *rng)
+{
+    Population *next = create_population(pop->size);
+    if (!next) return pop;
+
+    copy_chromosome(&next->individuals[0], &pop->individuals[0]);
+    for (int k = 1; k + 1 < pop->size; k += 2)
+    {
+        const Chromosome *a = &pop->individuals[rng_bounded(rng, pop->size)];
+        const Chromosome *b = &pop->individuals[rng_bounded(rng, pop->size)];
+        crossover_chromosomes(a, b, &next->individuals[k], &next->individuals[k + 1], 0.9f);
+        mutate_chromosome(&next->individuals[k], 0.01f, map);
+        mutate_chromosome(&next->individuals[k + 1], 0.01f, map);
+    }
+    if (pop->size % 2 == 0)
+        copy_chromosome(&next->individuals[pop->size - 1], &pop->individuals[pop->size - 1]);
+
+    free_population(pop);
+    return next;
+}
+
+// Decode into a fresh path, then score it with the allocating helpers
+static void bench_heap_evaluate(Population *pop, const Map3D *map)
+{
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int i = 0; i < pop->size; i++)
+    {
+        Chromosome *c = &pop->individuals[i];
+        free(c->actual_path);
+        c->actual_path = decode_chromosome_with_bounds(c, &c->actual_path_length, map);
+        c->survivors_rescued = count_survivors_on_path(c, map);
+        c->coverage_cells = count_coverage_cells(c, map);
+        c->total_length = calculate_path_length(c);
+        c->total_risk = calculate_path_risk(c, map);
+        c->valid = validate_chromosome(c, map);
+    }
+}
+
+static void bench_arena_breed(GenerationArenas *gens, Rng *rng)
+{
+    PopulationArena *cur = generation_current(gens);
+    PopulationArena *next = generation_next(gens);
+
+    arena_copy_individual(next, 0, cur, 0);
+    for (int k = 1; k + 1 < cur->size; k += 2)
+    {
+        int a = (int)rng_bounded(rng, cur->size);
+        int b = (int)rng_bounded(rng, cur->size);
+        arena_crossover(rng, cur, a, b, next, k, k + 1, 0.9f);
+        arena_mutate(rng, next, k, 0.01f);
+        arena_mutate(rng, next, k + 1, 0.01f);
+    }
+    if (cur->size % 2 == 0)
+        arena_copy_individual(next, cur->size - 1, cur, cur->size - 1);
+
+    generation_arenas_swap(gens);
+}
+
+void benchmark_population_arena(const Map3D *map)
+{
+    if (!map) return;
+
+    printf("\n🧫 Population arena benchmark (%d paths × %d moves, %d generations)\n",
+           BENCH_ARENA_SIZE, BENCH_ARENA_MOVES, BENCH_ARENA_GENERATIONS);
+    printf("--------------------------------------------------------------------\n");
+
+    Population *pop = create_initial_population(map->start_position, BENCH_ARENA_SIZE,
+                                                BENCH_ARENA_MOVES, map);
+    GenerationArenas *gens = create_generation_arenas(BENCH_ARENA_SIZE, BENCH_ARENA_MOVES, map);
+    if (!pop || !gens)
+    {
+        free_population(pop);
+        free_generation_arenas(gens);
+        return;
+    }
+    arena_randomize(generation_current(gens), map->start_position);
+
+    Rng rng;
+    double t_heap[2] = {0.0, 0.0}, t_arena[2] = {0.0, 0.0};
+
+    rng_seed(&rng, 7, 0);
+    for (int g = 0; g < BENCH_ARENA_GENERATIONS; g++)
+    {
+        double t0 = bench_now();
+        pop = bench_heap_breed(pop, map, &rng);
+        double t1 = bench_now();
+        bench_heap_evaluate(pop, map);
+        t_heap[0] += t1 - t0;
+        t_heap[1] += bench_now() - t1;
+    }
+
+    rng_seed(&rng, 7, 0);
+    for (int g = 0; g < BENCH_ARENA_GENERATIONS; g++)
+    {
+        double t0 = bench_now();
+        bench_arena_breed(gens, &rng);
+        double t1 = bench_now();
+        PopulationArena *cur = generation_current(gens);
+        arena_evaluate(cur, 0, cur->size, map, gens->workspaces, gens->workspace_count, NULL, NULL,
+                       10.0f, 1.0f, 0.1f, 0.5f);
+        t_arena[0] += t1 - t0;
+        t_arena[1] += bench_now() - t1;
+    }
+
+    printf("                        breed (ms)  evaluate (ms)   per generation\n");
+    printf(" Per-individual malloc: %10.2f  %13.2f\n",
+           t_heap[0] / BENCH_ARENA_GENERATIONS * 1e3, t_heap[1] / BENCH_ARENA_GENERATIONS * 1e3);
+    printf(" Double-buffered arena: %10.2f  %13.2f\n",
+           t_arena[0] / BENCH_ARENA_GENERATIONS * 1e3, t_arena[1] / BENCH_ARENA_GENERATIONS * 1e3);
+
+    free_population(pop);
+    free_generation_arenas(gens);
+}
+
+// ============================================================
+// INCREMENTAL EVALUATION
+// ============================================================
+#define BENCH_INC_PATHS 500
+#define BENCH_INC_MOVES 2000
+
+void benchmark_incremental_eval(const Map3D *map)
+{
+    if (!map) return;
+
+    printf("\n🔁 Incremental evaluation benchmark (%d paths × %d moves, rate 0.001)\n",
+           BENCH_INC_PATHS, BENCH_INC_MOVES);
+    printf("--------------------------------------------------------------------\n");
+
+    Population *parents = create_initial_population(map->start_position, BENCH_INC_PATHS,
+                                                    BENCH_INC_MOVES, map);
+    Population *children = create_population(BENCH_INC_PATHS);
+    if (!parents || !children)
+    {
+        free_population(parents);
+        free_population(children);
+        return;
+    }
+
+    for (int i = 0; i < BENCH_INC_PATHS; i++)
+        evaluate_chromosome_incremental(&parents->individuals[i], map, 10.0f, 1.0f, 0.1f, 0.5f);
+
+    // Children are mutated copies; both passes score the same genes
+    double t_full = 1e30, t_inc = 1e30;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        for (int i = 0; i < BENCH_INC_PATHS; i++)
+        {
+            copy_chromosome(&children->individuals[i], &parents->individuals[i]);
+            mutate_chromosome(&children->individuals[i], 0.001f, map);
+        }
+
+        double t0 = bench_now();
+        for (int i = 0; i < BENCH_INC_PATHS; i++)
+        {
+            Chromosome *c = &children->individuals[i];
+            PathMetrics m;
+            evaluate_path(c->moves, c->num_moves, c->start_pos, map, eval_workspace_thread(map),
+                          10.0f, 1.0f, 0.1f, 0.5f, &m, NULL);
+        }
+        double t = bench_now() - t0;
+        if (t < t_full) t_full = t;
+
+        t0 = bench_now();
+        for (int i = 0; i < BENCH_INC_PATHS; i++)
+            evaluate_chromosome_incremental(&children->individuals[i], map, 10.0f, 1.0f, 0.1f, 0.5f);
+        t = bench_now() - t0;
+        if (t < t_inc) t_inc = t;
+    }
+
+    // Spot-check the incremental results against a full walk
+    int mismatches = 0;
+    for (int i = 0; i < BENCH_INC_PATHS; i++)
+    {
+        Chromosome *c = &children->individuals[i];
+        PathMetrics m;
+        evaluate_path(c->moves, c->num_moves, c->start_pos, map, eval_workspace_thread(map),
+                      10.0f, 1.0f, 0.1f, 0.5f, &m, NULL);
+        if (m.coverage_cells != c->coverage_cells || m.survivors_rescued != c->survivors_rescued ||
+            fabsf(m.fitness - c->fitness) > 1e-3f * fmaxf(1.0f, fabsf(m.fitness)))
+            mismatches++;
+    }
+
+    printf(" Full walk:         %8.2f µs/path\n", t_full / BENCH_INC_PATHS * 1e6);
+    printf(" From checkpoint:   %8.2f µs/path  (%.2fx)\n", t_inc / BENCH_INC_PATHS * 1e6, t_full / t_inc);
+    printf(" Mismatches:        %d\n", mismatches);
+
+    free_population(parents);
+    free_population(children);
+}
+
+// ============================================================
+// FITNESS CACHE
+// ============================================================
+#define BENCH_CACHE_PATHS 2000
+#define BENCH_CACHE_MOVES 1000
+#define BENCH_CACHE_PARENTS 100
+
+// A converged population: every path is a lightly mutated copy of one of
+// a few parents, as in the late-generation plateau
+void benchmark_fitness_cache(const Map3D *map)
+{
+    if (!map) return;
+
+    printf("\n🗃️  Fitness cache benchmark (%d paths from %d parents, %d moves)\n",
+           BENCH_CACHE_PATHS, BENCH_CACHE_PARENTS, BENCH_CACHE_MOVES);
+    printf("--------------------------------------------------------------------\n");
+
+    GenerationArenas *gens = create_generation_arenas(BENCH_CACHE_PATHS, BENCH_CACHE_MOVES, map);
+    FitnessCache *cache = fitness_cache_create(FITNESS_CACHE_DEFAULT_ENTRIES, map);
+    if (!gens || !cache)
+    {
+        free_generation_arenas(gens);
+        fitness_cache_free(cache);
+        return;
+    }
+
+    PopulationArena *parents = generation_current(gens);
+    PopulationArena *pop = generation_next(gens);
+    arena_randomize(parents, map->start_position);
+
+    double t_plain = 0.0, t_cached = 0.0;
+    Rng rng;
+    rng_seed(&rng, 11, 0);
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        for (int i = 0; i < pop->size; i++)
+        {
+            arena_copy_individual(pop, i, parents, (int)rng_bounded(&rng, BENCH_CACHE_PARENTS));
+            arena_mutate(&rng, pop, i, 0.0005f);
+        }
+
+        double t0 = bench_now();
+        arena_evaluate(pop, 0, pop->size, map, gens->workspaces, gens->workspace_count, NULL, NULL,
+                       10.0f, 1.0f, 0.1f, 0.5f);
+        t_plain += bench_now() - t0;
+
+        t0 = bench_now();
+        arena_evaluate(pop, 0, pop->size, map, gens->workspaces, gens->workspace_count, cache, NULL,
+                       10.0f, 1.0f, 0.1f, 0.5f);
+        t_cached += bench_now() - t0;
+    }
+
+    printf(" Without cache:  %8.2f ms/generation\n", t_plain / BENCH_REPEATS * 1e3);
+    printf(" With cache:     %8.2f ms/generation  (%.2fx)\n",
+           t_cached / BENCH_REPEATS * 1e3, t_plain / t_cached);
+    printf(" ");
+    fitness_cache_print_stats(cache);
+
+    fitness_cache_free(cache);
+    free_generation_arenas(gens);
+}
+
+// ============================================================
+// PREFIX CACHE
+// ============================================================
+#define BENCH_PREFIX_PATHS 2000
+#define BENCH_PREFIX_MOVES 1000
+
+// Children of one-point crossover share their first parent's prefix;
+// parents are scored first, as in the previous generation
+void benchmark_prefix_cache(const Map3D *map)
+{
+    if (!map) return;
+
+    printf("\n🌳 Prefix cache benchmark (%d crossover children, %d moves)\n",
+           BENCH_PREFIX_PATHS, BENCH_PREFIX_MOVES);
+    printf("--------------------------------------------------------------------\n");
+
+    GenerationArenas *gens = create_generation_arenas(BENCH_PREFIX_PATHS, BENCH_PREFIX_MOVES, map);
+    PrefixCache *prefixes = prefix_cache_create(
+        4 * BENCH_PREFIX_PATHS * (BENCH_PREFIX_MOVES / PREFIX_BLOCK_MOVES), map);
+    if (!gens || !prefixes)
+    {
+        free_generation_arenas(gens);
+        prefix_cache_free(prefixes);
+        return;
+    }
+
+    PopulationArena *parents = generation_current(gens);
+    PopulationArena *children = generation_next(gens);
+    arena_randomize(parents, map->start_position);
+    arena_evaluate(parents, 0, parents->size, map, gens->workspaces, gens->workspace_count,
+                   NULL, prefixes, 10.0f, 1.0f, 0.1f, 0.5f);
+
+    Rng rng;
+    rng_seed(&rng, 13, 0);
+    for (int k = 0; k + 1 < children->size; k += 2)
+    {
+        arena_crossover(&rng, parents, (int)rng_bounded(&rng, parents->size),
+                        (int)rng_bounded(&rng, parents->size), children, k, k + 1, 1.0f);
+        arena_mutate(&rng, children, k, 0.0005f);
+        arena_mutate(&rng, children, k + 1, 0.0005f);
+    }
+
+    double t0 = bench_now();
+    arena_evaluate(children, 0, children->size, map, gens->workspaces, gens->workspace_count,
+                   NULL, NULL, 10.0f, 1.0f, 0.1f, 0.5f);
+    double t_plain = bench_now() - t0;
+
+    t0 = bench_now();
+    arena_evaluate(children, 0, children->size, map, gens->workspaces, gens->workspace_count,
+                   NULL, prefixes, 10.0f, 1.0f, 0.1f, 0.5f);
+    double t_prefix = bench_now() - t0;
+
+    printf(" Full walks:       %8.2f ms\n", t_plain * 1e3);
+    printf(" Shared prefixes:  %8.2f ms  (%.2fx)\n", t_prefix * 1e3, t_plain / t_prefix);
+    printf(" ");
+    prefix_cache_print_stats(prefixes);
+
+    prefix_cache_free(prefixes);
+    free_generation_arenas(gens);
+}
+
+// ============================================================
+// BATCH EVALUATION
+// ============================================================
+#define BENCH_BATCH_PATHS 2000
+#define BENCH_BATCH_MOVES 1000
+
+void benchmark_batch_eval(const Map3D *map)
+{
+    if (!map) return;
+
+    printf("\n🧮 Batch evaluation benchmark (%d paths, %d moves, %d lanes)\n",
+           BENCH_BATCH_PATHS, BENCH_BATCH_MOVES, EVAL_BATCH_LANES);
+    printf("--------------------------------------------------------------------\n");
+
+    if (!eval_batch_map_supported(map))
+        printf(" ⚠️ Map layout/storage not supported by the vector walk; paths go through the scalar kernel\n");
+
+    int mismatches = eval_batch_self_check(map, 512, 300);
+    if (mismatches == 0)
+        printf(" ✅ Batch kernels match the scalar kernel\n");
+    else
+        printf(" ❌ %d mismatching results against the scalar kernel\n", mismatches);
+
+    GenerationArenas *gens = create_generation_arenas(BENCH_BATCH_PATHS, BENCH_BATCH_MOVES, map);
+    if (!gens) return;
+
+    PopulationArena *pop = generation_current(gens);
+    arena_randomize(pop, map->start_position);
+
+    const EvalBatchKernel saved = eval_batch_kernel();
+    double t_scalar = 0.0;
+    for (int k = EVAL_BATCH_SCALAR; k <= EVAL_BATCH_AVX2; k++)
+    {
+        if (!eval_batch_select((EvalBatchKernel)k))
+        {
+            printf(" %-8s  not supported by this CPU\n", eval_batch_kernel_name((EvalBatchKernel)k));
+            continue;
+        }
+
+        double t0 = bench_now();
+        for (int r = 0; r < BENCH_REPEATS; r++)
+            evaluate_population_batch(pop, 0, pop->size, map, gens->workspaces, gens->workspace_count,
+                                      10.0f, 1.0f, 0.1f, 0.5f);
+        double t = (bench_now() - t0) / BENCH_REPEATS;
+        if (k == EVAL_BATCH_SCALAR) t_scalar = t;
+
+        printf(" %-8s  %8.2f ms/generation  (%.2fx)\n",
+               eval_batch_kernel_name((EvalBatchKernel)k), t * 1e3, t_scalar / t);
+    }
+    eval_batch_select(saved);
+    printf(" Selected kernel: %s\n", eval_batch_kernel_name(saved));
+
+    free_generation_arenas(gens);
+}
+
+// ============================================================
+// SELECTION
+// ============================================================
+#define BENCH_SELECTION_SIZE 100000
+#define BENCH_SELECTION_LINEAR_PICKS 200
+
+void benchmark_selection(void)
+{
+    printf("\n🎯 Selection benchmark (%d individuals)\n", BENCH_SELECTION_SIZE);
+    printf("--------------------------------------------------------------------\n");
+
+    // Alias sampling against exact probabilities on a small table
+    const float weights[5] = {1.0f, 2.0f, 3.0f, 4.0f, 0.0f};
+    const int draws = 1000000;
+    int hits[5] = {0};
+    AliasTable table = {0};
+    Rng rng;
+    rng_seed(&rng, 23, 0);
+    if (alias_table_build(&table, weights, 5))
+    {
+        for (int d = 0; d < draws; d++) hits[alias_table_sample(&table, &rng)]++;
+        double worst = 0.0;
+        for (int i = 0; i < 5; i++)
+        {
+            double err = fabs(hits[i] / (double)draws - weights[i] / 10.0);
+            if (err > worst) worst = err;
+        }
+        printf(" %s Alias table frequencies within %.4f of the weights (%d draws)\n",
+               worst < 0.005 ? "✅" : "❌", worst, draws);
+    }
+    alias_table_release(&table);
+
+    // Heap population: only the fitness is filled in
+    Population *pop = create_population(BENCH_SELECTION_SIZE);
+    if (!pop) return;
+    for (int i = 0; i < pop->size; i++)
+        pop->individuals[i].fitness = rng_float(&rng) * 100.0f - 20.0f;
+
+    double t0 = bench_now();
+    volatile int sink = 0;
+    for (int k = 0; k < BENCH_SELECTION_LINEAR_PICKS; k++)
+        sink += (int)(roulette_wheel_selection(pop) - pop->individuals);
+    double t_linear = (bench_now() - t0) / BENCH_SELECTION_LINEAR_PICKS;
+
+    t0 = bench_now();
+    prepare_selection(pop);
+    double t_prepare = bench_now() - t0;
+
+    const struct {
+        const char *name;
+        int kind;
+    } ops[3] = {{"Roulette (alias)", 0}, {"Rank (alias)", 1}, {"Tournament k=5", 2}};
+
+    printf(" Tables per generation:  %8.3f ms\n", t_prepare * 1e3);
+    printf(" Roulette (linear scan): %8.1f ns/pick → %8.1f ms per generation\n",
+           t_linear * 1e9, t_linear * pop->size * 1e3);
+    for (int o = 0; o < 3; o++)
+    {
+        t0 = bench_now();
+        for (int k = 0; k < pop->size; k++)
+        {
+            Chromosome *c = ops[o].kind == 0 ? roulette_wheel_selection(pop) :
+                            ops[o].kind == 1 ? rank_selection(pop) : tournament_selection(pop, 5);
+            sink += (int)(c - pop->individuals);
+        }
+        double t = (bench_now() - t0) / pop->size;
+        printf(" %-23s %8.1f ns/pick → %8.1f ms per generation\n",
+               ops[o].name, t * 1e9, t * pop->size * 1e3);
+    }
+    (void)sink;
+
+    free_population(pop);
+}
+
+// ============================================================
+// RANKING
+// ============================================================
+#define BENCH_RANKING_SIZE 100000
+
+static int bench_compare_keys(const void *a, const void *b)
+{
+    const FitnessKey *x = (const FitnessKey *)a;
+    const FitnessKey *y = (const FitnessKey *)b;
+    if (x->fitness != y->fitness) return x->fitness > y->fitness ? -1 : 1;
+    return x->index - y->index;
+}
+
+void benchmark_ranking(void)
+{
+    const int n = BENCH_RANKING_SIZE;
+    const int elites = n / 10;
+
+    printf("\n🏆 Ranking benchmark (%d keys, best %d)\n", n, elites);
+    printf("--------------------------------------------------------------------\n");
+
+    FitnessKey *keys = (FitnessKey *)malloc(n * sizeof(FitnessKey));
+    FitnessKey *expected = (FitnessKey *)malloc(n * sizeof(FitnessKey));
+    FitnessKey *sorted = (FitnessKey *)malloc(2 * (size_t)n * sizeof(FitnessKey));
+    float *fitness = (float *)malloc(n * sizeof(float));
+    int32_t *order = (int32_t *)malloc(n * sizeof(int32_t));
+    if (!keys || !expected || !sorted || !fitness || !order)
+    {
+        printf("❌ Memory allocation error for ranking benchmark\n");
+        free(keys); free(expected); free(sorted); free(fitness); free(order);
+        return;
+    }
+
+    Rng rng;
+    rng_seed(&rng, 29, 0);
+    for (int i = 0; i < n; i++)
+    {
+        // Quantized so ties are common, as in a converged population
+        fitness[i] = (float)rng_bounded(&rng, 20000) * 0.025f - 100.0f;
+        keys[i].fitness = fitness[i];
+        keys[i].index = i;
+    }
+
+    double t_qsort = 0.0, t_radix = 0.0, t_heap = 0.0, t_select = 0.0;
+    bool match = true;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        memcpy(expected, keys, n * sizeof(FitnessKey));
+        double t0 = bench_now();
+        qsort(expected, n, sizeof(FitnessKey), bench_compare_keys);
+        t_qsort += bench_now() - t0;
+
+        memcpy(sorted, keys, n * sizeof(FitnessKey));
+        t0 = bench_now();
+        fitness_keys_radix_sort(sorted, sorted + n, n, true);
+        t_radix += bench_now() - t0;
+        match = match && memcmp(sorted, expected, n * sizeof(FitnessKey)) == 0;
+
+        t0 = bench_now();
+        fitness_keys_top_k(keys, n, elites, sorted);
+        t_heap += bench_now() - t0;
+        match = match && memcmp(sorted, expected, elites * sizeof(FitnessKey)) == 0;
+
+        t0 = bench_now();
+        fitness_select_top(fitness, n, elites, order);
+        t_select += bench_now() - t0;
+        for (int e = 0; e < elites; e++)
+            match = match && fitness[order[e]] >= expected[elites - 1].fitness;
+    }
+
+    printf(" %s Radix sort, top-k heap and quickselect agree with qsort\n", match ? "✅" : "❌");
+    printf(" qsort, full order:        %8.3f ms\n", t_qsort / BENCH_REPEATS * 1e3);
+    printf(" Radix sort, full order:   %8.3f ms  (%.2fx)\n",
+           t_radix / BENCH_REPEATS * 1e3, t_qsort / t_radix);
+    printf(" Top-k heap, best first:   %8.3f ms  (%.2fx)\n",
+           t_heap / BENCH_REPEATS * 1e3, t_qsort / t_heap);
+    printf(" Quickselect, unordered:   %8.3f ms  (%.2fx)\n",
+           t_select / BENCH_REPEATS * 1e3, t_qsort / t_select);
+
+    free(keys); free(expected); free(sorted); free(fitness); free(order);
+}
+
+// ============================================================
+// ALL BENCHMARKS
+// ============================================================
+void run_benchmarks(const Map3D *map)
+{
+    if (!map)
+    {
+        printf("⚠️ Please create or load a map first\n");
+        return;
+    }
+
+    printf("\n════════════════════════════════════════════════════════════════\n");
+    printf("                    PERFORMANCE BENCHMARKS                      \n");
+    printf("════════════════════════════════════════════════════════════════\n");
+    printf(" Map: %d × %d × %d, %d survivors\n",
+           map->width, map->height, map->depth, map->survivor_count);
+
+    benchmark_text_map_loader(BENCH_TEXT_FILE);
+    benchmark_sparse_storage(map);
+    benchmark_components(map);
+    benchmark_layouts(map);
+    benchmark_genes();
+    benchmark_population_arena(map);
+    benchmark_incremental_eval(map);
+    benchmark_fitness_cache(map);
+    benchmark_prefix_cache(map);
+    benchmark_batch_eval(map);
+    benchmark_selection();
+    benchmark_ranking();
+
+    printf("════════════════════════════════════════════════════════════════\n");
+}
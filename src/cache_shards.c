@@ -0,0 +1,29 @@
+#include "cache_shards.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// SHARDED LOCKS
+// ============================================================
+// The caches split their tables over independent locks; each shard
+// struct starts with a ShardLock, which pads it to whole cache lines so
+// neighbouring shards never share one.
+
+void *sharded_cache_alloc(size_t bytes)
+{
+    void *p = aligned_alloc(64, (bytes + 63) & ~(size_t)63);
+    if (p) memset(p, 0, bytes);
+    return p;
+}
+
+void shard_locks_init(void *shards, size_t stride, int count)
+{
+    for (int s = 0; s < count; s++)
+        omp_init_lock(&((ShardLock *)((char *)shards + (size_t)s * stride))->lock);
+}
+
+void shard_locks_destroy(void *shards, size_t stride, int count)
+{
+    for (int s = 0; s < count; s++)
+        omp_destroy_lock(&((ShardLock *)((char *)shards + (size_t)s * stride))->lock);
+}
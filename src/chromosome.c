@@ -1,4 +1,9 @@
 #include "chromosome.h"
+#include "map_fields.h"
+#include "map_distance.h"
+#include "path_eval.h"
+#include "selection.h"
+#include "rng.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,11 +17,24 @@
 
 // ============= Chromosome Functions =============
 
+// Moves outside the Direction range act like DIR_WAIT
+static inline int move_index(Direction dir) {
+    return (unsigned)dir < MAP_MOVE_COUNT ? (int)dir : DIR_WAIT;
+}
+
+static inline Position apply_move(Position pos, Direction dir) {
+    const Position *step = &map_move_offsets[move_index(dir)];
+    pos.x += step->x;
+    pos.y += step->y;
+    pos.z += step->z;
+    return pos;
+}
+
 Chromosome* create_chromosome(Position start, int max_steps) {
     Chromosome *chrom = (Chromosome*)malloc(sizeof(Chromosome));
     if (!chrom) return NULL;
     
-    chrom->moves = (Direction*)malloc(max_steps * sizeof(Direction));
+    chrom->moves = (Gene*)malloc(max_steps * sizeof(Gene));
     if (!chrom->moves) {
         free(chrom);
         return NULL;
@@ -34,10 +52,12 @@ Chromosome* create_chromosome(Position start, int max_steps) {
     chrom->total_risk = 0.0f;
     chrom->time_estimate = 0.0f;
     
-    chrom->id = rand() % 1000000;
+    chrom->id = (int)rng_bounded(rng_thread(), 1000000);
     chrom->valid = false;
     chrom->actual_path = NULL;
     chrom->actual_path_length = 0;
+    chrom->trace = NULL;
+    chrom->dirty_from = 0;
     
     return chrom;
 }
@@ -49,9 +69,7 @@ Chromosome* create_random_chromosome(Position start, int max_steps) {
     chrom->num_moves = max_steps;
     
     // Generate random moves
-    for (int i = 0; i < max_steps; i++) {
-        chrom->moves[i] = get_random_direction();
-    }
+    rng_fill_bounded_u8(rng_thread(), MAP_MOVE_COUNT, chrom->moves, max_steps);
     
     return chrom;
 }
@@ -59,7 +77,7 @@ Chromosome* create_random_chromosome(Position start, int max_steps) {
 void init_chromosome(Chromosome *chrom, Position start, int max_steps) {
     if (chrom->moves) free(chrom->moves);
     
-    chrom->moves = (Direction*)malloc(max_steps * sizeof(Direction));
+    chrom->moves = (Gene*)malloc(max_steps * sizeof(Gene));
     chrom->start_pos = start;
     chrom->num_moves = 0;
     chrom->max_moves = max_steps;
@@ -71,26 +89,30 @@ void init_chromosome(Chromosome *chrom, Position start, int max_steps) {
     chrom->total_risk = 0.0f;
     chrom->time_estimate = 0.0f;
     
-    chrom->id = rand() % 1000000;
+    chrom->id = (int)rng_bounded(rng_thread(), 1000000);
     chrom->valid = false;
     chrom->actual_path = NULL;
     chrom->actual_path_length = 0;
+    
+    eval_trace_free(chrom->trace);
+    chrom->trace = NULL;
+    chrom->dirty_from = 0;
 }
 
 void init_random_chromosome(Chromosome *chrom, Position start, int max_steps) {
     init_chromosome(chrom, start, max_steps);
     chrom->num_moves = max_steps;
     
-    for (int i = 0; i < max_steps; i++) {
-        chrom->moves[i] = get_random_direction();
-    }
+    rng_fill_bounded_u8(rng_thread(), MAP_MOVE_COUNT, chrom->moves, max_steps);
 }
 
 void copy_chromosome(Chromosome *dest, const Chromosome *src) {
-    if (dest->moves) free(dest->moves);
-    
-    dest->moves = (Direction*)malloc(src->max_moves * sizeof(Direction));
-    memcpy(dest->moves, src->moves, src->num_moves * sizeof(Direction));
+    // Reuse the gene buffer when the capacity already matches
+    if (!dest->moves || dest->max_moves != src->max_moves) {
+        free(dest->moves);
+        dest->moves = (Gene*)malloc(src->max_moves * sizeof(Gene));
+    }
+    memcpy(dest->moves, src->moves, src->num_moves * sizeof(Gene));
     
     dest->start_pos = src->start_pos;
     dest->num_moves = src->num_moves;
@@ -107,8 +129,16 @@ void copy_chromosome(Chromosome *dest, const Chromosome *src) {
     dest->valid = src->valid;
     
     // Don't copy actual_path as it's temporary
+    free(dest->actual_path);
     dest->actual_path = NULL;
     dest->actual_path_length = 0;
+    
+    // The trace comes along so a mutated copy re-evaluates incrementally
+    if (!eval_trace_copy_prefix(&dest->trace, src->trace, src->num_moves)) {
+        eval_trace_free(dest->trace);
+        dest->trace = NULL;
+    }
+    dest->dirty_from = src->dirty_from;
 }
 
 Chromosome* clone_chromosome(const Chromosome *src) {
@@ -123,6 +153,7 @@ void free_chromosome(Chromosome *chrom) {
     if (chrom) {
         if (chrom->moves) free(chrom->moves);
         if (chrom->actual_path) free(chrom->actual_path);
+        eval_trace_free(chrom->trace);
         free(chrom);
     }
 }
@@ -140,157 +171,141 @@ Position* decode_chromosome_to_path(const Chromosome *chrom, int *path_length) {
     
     // Apply each move
     for (int i = 0; i < chrom->num_moves; i++) {
-        Position next = current;
-        
-        switch (chrom->moves[i]) {
-            case DIR_RIGHT: next.x++; break;
-            case DIR_LEFT: next.x--; break;
-            case DIR_UP: next.y++; break;
-            case DIR_DOWN: next.y--; break;
-            case DIR_FORWARD: next.z++; break;
-            case DIR_BACKWARD: next.z--; break;
-            case DIR_WAIT: break; // No change
-        }
-        
-        current = next;
+        current = apply_move(current, chrom->moves[i]);
         path[i + 1] = current;
     }
     
     return path;
 }
 
-Position* decode_chromosome_with_bounds(const Chromosome *chrom, int *path_length, 
-                                        const Map3D *map) {
-    *path_length = chrom->num_moves + 1;
-    Position *path = (Position*)malloc((*path_length) * sizeof(Position));
+void decode_moves_with_bounds(const Gene *moves, int count, Position start,
+                              const Map3D *map, Position *path) {
+    path[0] = start;
+    Position current = start;
     
-    path[0] = chrom->start_pos;
-    Position current = chrom->start_pos;
+    // A start off the map never moves
+    bool inside = is_valid_position(map, current);
+    size_t idx = inside ? map_pos_index(map, current) : 0;
     
-    for (int i = 0; i < chrom->num_moves; i++) {
-        Position next = current;
-        
-        switch (chrom->moves[i]) {
-            case DIR_RIGHT: 
-                if (current.x < map->width - 1) next.x++; 
-                break;
-            case DIR_LEFT: 
-                if (current.x > 0) next.x--; 
-                break;
-            case DIR_UP: 
-                if (current.y < map->height - 1) next.y++; 
-                break;
-            case DIR_DOWN: 
-                if (current.y > 0) next.y--; 
-                break;
-            case DIR_FORWARD: 
-                if (current.z < map->depth - 1) next.z++; 
-                break;
-            case DIR_BACKWARD: 
-                if (current.z > 0) next.z--; 
-                break;
-            case DIR_WAIT: 
-                break;
-        }
+    for (int i = 0; i < count; i++) {
+        int m = move_index(moves[i]);
         
-        // Update only if coordinates changed and within bounds
-        if (!positions_equal(current, next)) {
-            current = next;
+        // Moves into the border are dropped, which clamps to the bounds
+        size_t next = map_step(map, idx, m);
+        if (inside && map_cell_at(map, next) != CELL_BORDER) {
+            idx = next;
+            current = apply_move(current, (Direction)m);
         }
         
         path[i + 1] = current;
     }
+}
+
+Position* decode_chromosome_with_bounds(const Chromosome *chrom, int *path_length, 
+                                        const Map3D *map) {
+    *path_length = chrom->num_moves + 1;
+    Position *path = (Position*)malloc((*path_length) * sizeof(Position));
+    if (!path) return NULL;
     
+    decode_moves_with_bounds(chrom->moves, chrom->num_moves, chrom->start_pos, map, path);
     return path;
 }
 
 // ============= Evaluation Functions =============
 
+// Scores the chromosome with the fused kernel. The decoded path is not
+// kept; call build_chromosome_path when it is needed for display.
 float evaluate_chromosome_fitness(Chromosome *chrom, const Map3D *map, 
                                   float w_survivors, float w_coverage, 
                                   float w_length, float w_risk) {
+    PathMetrics metrics;
+    evaluate_path(chrom->moves, chrom->num_moves, chrom->start_pos, map,
+                  eval_workspace_thread(map), w_survivors, w_coverage,
+                  w_length, w_risk, &metrics, NULL);
+    
+    chrom->fitness = metrics.fitness;
+    chrom->survivors_rescued = metrics.survivors_rescued;
+    chrom->coverage_cells = metrics.coverage_cells;
+    chrom->total_length = metrics.total_length;
+    chrom->total_risk = metrics.total_risk;
+    chrom->time_estimate = metrics.time_estimate;
+    chrom->valid = metrics.valid;
+    
+    // Any stored path may predate the current genes
+    free(chrom->actual_path);
+    chrom->actual_path = NULL;
+    chrom->actual_path_length = 0;
     
-    // 1. Convert to path
-    int path_length;
-    Position *path = decode_chromosome_with_bounds(chrom, &path_length, map);
-    
-    // 2. Calculate components
-    chrom->survivors_rescued = count_survivors_on_path(chrom, map);
-    chrom->coverage_cells = count_coverage_cells(chrom, map);
-    chrom->total_length = calculate_path_length(chrom);
-    chrom->total_risk = calculate_path_risk(chrom, map);
-    
-    // 3. Apply fitness formula
-    chrom->fitness = (w_survivors * chrom->survivors_rescued) +
-                     (w_coverage * chrom->coverage_cells) -
-                     (w_length * chrom->total_length) -
-                     (w_risk * chrom->total_risk);
-    
-    // 4. Estimated time (approximate)
-    chrom->time_estimate = chrom->total_length * 0.5f; // 0.5 seconds per unit
-    
-    // 5. Validate
-    chrom->valid = validate_chromosome(chrom, map);
+    return chrom->fitness;
+}
+
+float evaluate_chromosome_incremental(Chromosome *chrom, const Map3D *map,
+                                      float w_survivors, float w_coverage,
+                                      float w_length, float w_risk) {
+    if (!chrom->trace) {
+        chrom->trace = (EvalTrace*)calloc(1, sizeof(EvalTrace));
+        if (!chrom->trace) {
+            return evaluate_chromosome_fitness(chrom, map, w_survivors, w_coverage,
+                                               w_length, w_risk);
+        }
+    }
     
-    // 6. Save actual path (temporary)
-    if (chrom->actual_path) free(chrom->actual_path);
-    chrom->actual_path = path;
-    chrom->actual_path_length = path_length;
+    PathMetrics metrics;
+    evaluate_path_incremental(chrom->moves, chrom->num_moves, chrom->start_pos, map,
+                              eval_workspace_thread(map), chrom->trace, chrom->dirty_from,
+                              w_survivors, w_coverage, w_length, w_risk, &metrics);
+    
+    chrom->fitness = metrics.fitness;
+    chrom->survivors_rescued = metrics.survivors_rescued;
+    chrom->coverage_cells = metrics.coverage_cells;
+    chrom->total_length = metrics.total_length;
+    chrom->total_risk = metrics.total_risk;
+    chrom->time_estimate = metrics.time_estimate;
+    chrom->valid = metrics.valid;
+    chrom->dirty_from = CHROMOSOME_CLEAN;
+    
+    free(chrom->actual_path);
+    chrom->actual_path = NULL;
+    chrom->actual_path_length = 0;
     
     return chrom->fitness;
 }
 
-int count_survivors_on_path(const Chromosome *chrom, const Map3D *map) {
-    if (!chrom->actual_path) return 0;
-    
+bool build_chromosome_path(Chromosome *chrom, const Map3D *map) {
+    free(chrom->actual_path);
+    chrom->actual_path = decode_chromosome_with_bounds(chrom, &chrom->actual_path_length, map);
+    if (!chrom->actual_path) {
+        chrom->actual_path_length = 0;
+        return false;
+    }
+    return true;
+}
+
+// found must be all zero on entry; only the bits this path set are
+// cleared again before returning, so large buffers stay cheap to reuse
+int count_survivors_in_path(const Position *path, int length, const Map3D *map,
+                            uint64_t *found) {
+    if (map->survivor_count == 0) return 0;
+    
+    // One bit per survivor: each survivor counts once however many
+    // path cells detect it
     int count = 0;
-    bool visited[map->width][map->height][map->depth];
-    memset(visited, 0, sizeof(visited));
     
-    for (int i = 0; i < chrom->actual_path_length; i++) {
-        Position pos = chrom->actual_path[i];
-        
-        if (pos.x >= 0 && pos.x < map->width &&
-            pos.y >= 0 && pos.y < map->height &&
-            pos.z >= 0 && pos.z < map->depth) {
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < length; i++) {
+            Position pos = path[i];
+            if (!is_valid_position(map, pos)) continue;
             
-            if (!visited[pos.x][pos.y][pos.z]) {
-                visited[pos.x][pos.y][pos.z] = true;
-                
-                // Check for survivor in this cell
-                for (int s = 0; s < map->survivor_count; s++) {
-                    if (positions_equal(map->survivors[s].pos, pos)) {
-                        count++;
-                        break;
-                    }
-                }
-                
-                // Check neighboring cells (radius 1)
-                for (int dx = -1; dx <= 1; dx++) {
-                    for (int dy = -1; dy <= 1; dy++) {
-                        for (int dz = -1; dz <= 1; dz++) {
-                            Position neighbor = {
-                                pos.x + dx,
-                                pos.y + dy,
-                                pos.z + dz
-                            };
-                            
-                            if (neighbor.x >= 0 && neighbor.x < map->width &&
-                                neighbor.y >= 0 && neighbor.y < map->height &&
-                                neighbor.z >= 0 && neighbor.z < map->depth &&
-                                !visited[neighbor.x][neighbor.y][neighbor.z]) {
-                                
-                                visited[neighbor.x][neighbor.y][neighbor.z] = true;
-                                
-                                for (int s = 0; s < map->survivor_count; s++) {
-                                    if (positions_equal(map->survivors[s].pos, neighbor)) {
-                                        count++;
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
+            int n;
+            const int32_t *ids = map_detectable_survivors(map, map_pos_index(map, pos), &n);
+            
+            for (int k = 0; k < n; k++) {
+                uint64_t bit = 1ULL << (ids[k] & 63);
+                if (pass == 1) {
+                    found[ids[k] >> 6] &= ~bit;
+                } else if (!(found[ids[k] >> 6] & bit)) {
+                    found[ids[k] >> 6] |= bit;
+                    count++;
                 }
             }
         }
@@ -299,27 +314,50 @@ int count_survivors_on_path(const Chromosome *chrom, const Map3D *map) {
     return count;
 }
 
-int count_coverage_cells(const Chromosome *chrom, const Map3D *map) {
-    if (!chrom->actual_path) return 0;
-    
-    bool visited[map->width][map->height][map->depth];
-    memset(visited, 0, sizeof(visited));
+// Same contract as count_survivors_in_path, one bit per padded cell
+int count_cells_in_path(const Position *path, int length, const Map3D *map,
+                        uint64_t *visited) {
     int count = 0;
     
-    for (int i = 0; i < chrom->actual_path_length; i++) {
-        Position pos = chrom->actual_path[i];
+    for (int i = 0; i < length; i++) {
+        if (!is_valid_position(map, path[i])) continue;
         
-        if (pos.x >= 0 && pos.x < map->width &&
-            pos.y >= 0 && pos.y < map->height &&
-            pos.z >= 0 && pos.z < map->depth) {
-            
-            if (!visited[pos.x][pos.y][pos.z]) {
-                visited[pos.x][pos.y][pos.z] = true;
-                count++;
-            }
+        size_t idx = map_pos_index(map, path[i]);
+        uint64_t bit = 1ULL << (idx & 63);
+        
+        if (!(visited[idx >> 6] & bit)) {
+            visited[idx >> 6] |= bit;
+            count++;
         }
     }
     
+    for (int i = 0; i < length; i++) {
+        if (is_valid_position(map, path[i]))
+            visited[map_pos_index(map, path[i]) >> 6] = 0;
+    }
+    
+    return count;
+}
+
+int count_survivors_on_path(const Chromosome *chrom, const Map3D *map) {
+    if (!chrom->actual_path || map->survivor_count == 0) return 0;
+    
+    uint64_t *found = (uint64_t*)calloc(((size_t)map->survivor_count + 63) / 64, sizeof(uint64_t));
+    if (!found) return 0;
+    
+    int count = count_survivors_in_path(chrom->actual_path, chrom->actual_path_length, map, found);
+    free(found);
+    return count;
+}
+
+int count_coverage_cells(const Chromosome *chrom, const Map3D *map) {
+    if (!chrom->actual_path) return 0;
+    
+    uint64_t *visited = (uint64_t*)calloc((map->cell_count + 63) / 64, sizeof(uint64_t));
+    if (!visited) return 0;
+    
+    int count = count_cells_in_path(chrom->actual_path, chrom->actual_path_length, map, visited);
+    free(visited);
     return count;
 }
 
@@ -353,34 +391,228 @@ float calculate_path_risk(const Chromosome *chrom, const Map3D *map) {
             pos.y >= 0 && pos.y < map->height &&
             pos.z >= 0 && pos.z < map->depth) {
             
-            // Risk from nearby obstacles
-            for (int dx = -2; dx <= 2; dx++) {
-                for (int dy = -2; dy <= 2; dy++) {
-                    for (int dz = -2; dz <= 2; dz++) {
-                        Position neighbor = {
-                            pos.x + dx,
-                            pos.y + dy,
-                            pos.z + dz
-                        };
-                        
-                        if (neighbor.x >= 0 && neighbor.x < map->width &&
-                            neighbor.y >= 0 && neighbor.y < map->height &&
-                            neighbor.z >= 0 && neighbor.z < map->depth) {
-                            
-                            if (map->grid[neighbor.x][neighbor.y][neighbor.z] == 1) { // Obstacle
-                                float distance = sqrtf(dx*dx + dy*dy + dz*dz);
-                                risk += 1.0f / (distance + 1.0f);
-                            }
-                        }
-                    }
-                }
-            }
+            // Risk from nearby obstacles (precomputed per cell)
+            risk += map_risk_at(map, map_pos_index(map, pos));
         }
     }
     
     return risk;
 }
 
+// ============= Gene Packing =============
+// Genes are worked on one byte each; stored paths use 3 bits per gene,
+// 21 genes to a 64-bit word (gene k of a word sits at bit 3k, the top
+// bit stays zero).
+
+void pack_genes(const Gene *genes, int count, uint64_t *words) {
+    for (int base = 0, w = 0; base < count; base += GENES_PER_WORD, w++) {
+        int n = count - base < GENES_PER_WORD ? count - base : GENES_PER_WORD;
+        uint64_t word = 0;
+        for (int k = n - 1; k >= 0; k--)
+            word = (word << GENE_BITS) | (genes[base + k] & GENE_MASK);
+        words[w] = word;
+    }
+}
+
+// Unpacks a whole word at a time; the fixed-count loop unrolls fully
+static inline void unpack_gene_word(uint64_t word, Gene *out) {
+    for (int k = 0; k < GENES_PER_WORD; k++, word >>= GENE_BITS)
+        out[k] = (Gene)(word & GENE_MASK);
+}
+
+void unpack_genes(const uint64_t *words, int count, Gene *genes) {
+    int full = count / GENES_PER_WORD;
+    for (int w = 0; w < full; w++)
+        unpack_gene_word(words[w], genes + w * GENES_PER_WORD);
+
+    uint64_t word = full < (int)packed_gene_words(count) ? words[full] : 0;
+    for (int i = full * GENES_PER_WORD; i < count; i++, word >>= GENE_BITS)
+        genes[i] = (Gene)(word & GENE_MASK);
+}
+
+// child = a[0, point) + b[point, count), spliced a word at a time
+void packed_genes_crossover(const uint64_t *a, const uint64_t *b, int point,
+                            int count, uint64_t *child) {
+    size_t words = packed_gene_words(count);
+    size_t split = (size_t)point / GENES_PER_WORD;
+    if (split > words) split = words;
+
+    memcpy(child, a, split * sizeof(uint64_t));
+    if (split < words) {
+        uint64_t mask = ((uint64_t)1 << (GENE_BITS * (point % GENES_PER_WORD))) - 1;
+        child[split] = (a[split] & mask) | (b[split] & ~mask);
+        memcpy(child + split + 1, b + split + 1, (words - split - 1) * sizeof(uint64_t));
+    }
+}
+
+// ============= Genetic Operators =============
+
+// One of the 6 directions other than g, uniformly
+static inline Gene random_other_gene(Rng *rng, Gene g) {
+    return (Gene)((move_index(g) + 1 + rng_bounded(rng, MAP_MOVE_COUNT - 1)) % MAP_MOVE_COUNT);
+}
+
+// Grows the gene buffer to at least capacity moves
+static bool reserve_genes(Chromosome *chrom, int capacity) {
+    if (chrom->moves && chrom->max_moves >= capacity) return true;
+
+    Gene *moves = (Gene*)realloc(chrom->moves, capacity * sizeof(Gene));
+    if (!moves) return false;
+    chrom->moves = moves;
+    chrom->max_moves = capacity;
+    return true;
+}
+
+// Clears results that no longer describe the genes
+static void reset_evaluation(Chromosome *chrom) {
+    chrom->fitness = 0.0f;
+    chrom->survivors_rescued = 0;
+    chrom->coverage_cells = 0;
+    chrom->total_length = 0.0f;
+    chrom->total_risk = 0.0f;
+    chrom->time_estimate = 0.0f;
+    chrom->valid = false;
+
+    free(chrom->actual_path);
+    chrom->actual_path = NULL;
+    chrom->actual_path_length = 0;
+}
+
+int mutate_genes(Rng *rng, Gene *genes, int count, float mutation_rate) {
+    if (mutation_rate <= 0.0f) return count;
+
+    if (mutation_rate >= 1.0f) {
+        for (int i = 0; i < count; i++)
+            genes[i] = random_other_gene(rng, genes[i]);
+        return 0;
+    }
+
+    // Gaps between mutated genes are geometric, so skip straight to the
+    // next hit instead of drawing a number per gene
+    const double log_keep = log(1.0 - mutation_rate);
+    int first = count;
+    for (int i = -1;;) {
+        double gap = floor(log(1.0 - rng_float(rng)) / log_keep);
+        if (gap >= (double)(count - 1 - i)) break;
+        i += 1 + (int)gap;
+        genes[i] = random_other_gene(rng, genes[i]);
+        if (first == count) first = i;
+    }
+    return first;
+}
+
+void mutate_chromosome(Chromosome *chrom, float mutation_rate, const Map3D *map) {
+    (void)map;
+    if (!chrom || !chrom->moves) return;
+    int first = mutate_genes(rng_thread(), chrom->moves, chrom->num_moves, mutation_rate);
+    if (first < chrom->num_moves) chromosome_mark_dirty(chrom, first);
+}
+
+void mutate_direction(Chromosome *chrom, int move_index) {
+    if (!chrom || move_index < 0 || move_index >= chrom->num_moves) return;
+    chrom->moves[move_index] = random_other_gene(rng_thread(), chrom->moves[move_index]);
+    chromosome_mark_dirty(chrom, move_index);
+}
+
+void mutate_insert_move(Chromosome *chrom, int position) {
+    if (!chrom || position < 0 || position > chrom->num_moves) return;
+
+    // A full chromosome drops its last move to make room
+    int n = chrom->num_moves < chrom->max_moves ? chrom->num_moves + 1 : chrom->num_moves;
+    if (position >= n) return;
+
+    memmove(chrom->moves + position + 1, chrom->moves + position, n - position - 1);
+    chrom->moves[position] = (Gene)rng_bounded(rng_thread(), MAP_MOVE_COUNT);
+    chrom->num_moves = n;
+    chromosome_mark_dirty(chrom, position);
+}
+
+void mutate_delete_move(Chromosome *chrom, int position) {
+    if (!chrom || chrom->num_moves <= 1 || position < 0 || position >= chrom->num_moves) return;
+
+    memmove(chrom->moves + position, chrom->moves + position + 1, chrom->num_moves - position - 1);
+    chrom->num_moves--;
+    chromosome_mark_dirty(chrom, position);
+}
+
+void mutate_swap_moves(Chromosome *chrom, int pos1, int pos2) {
+    if (!chrom || pos1 < 0 || pos2 < 0 ||
+        pos1 >= chrom->num_moves || pos2 >= chrom->num_moves) return;
+
+    Gene tmp = chrom->moves[pos1];
+    chrom->moves[pos1] = chrom->moves[pos2];
+    chrom->moves[pos2] = tmp;
+    chromosome_mark_dirty(chrom, pos1 < pos2 ? pos1 : pos2);
+}
+
+// Single-point crossover on raw gene buffers, which must not overlap.
+// Returns how many leading genes each child shares with the parent it
+// starts with (the longer length when the parents were copied through).
+int crossover_genes(Rng *rng, const Gene *a, int na, const Gene *b, int nb,
+                     Gene *child1, int *n1, Gene *child2, int *n2,
+                     float crossover_rate) {
+    const int shorter = na < nb ? na : nb;
+
+    if (shorter < 2 || rng_float(rng) >= crossover_rate) {
+        memcpy(child1, a, na * sizeof(Gene));
+        memcpy(child2, b, nb * sizeof(Gene));
+        *n1 = na;
+        *n2 = nb;
+        return na > nb ? na : nb;
+    }
+
+    int point = 1 + (int)rng_bounded(rng, shorter - 1);
+
+    memcpy(child1, a, point * sizeof(Gene));
+    memcpy(child1 + point, b + point, (nb - point) * sizeof(Gene));
+    memcpy(child2, b, point * sizeof(Gene));
+    memcpy(child2 + point, a + point, (na - point) * sizeof(Gene));
+    *n1 = nb;
+    *n2 = na;
+    return point;
+}
+
+// Children must not alias the parents; their gene buffers are grown as
+// needed and evaluation results are cleared.
+void crossover_chromosomes(const Chromosome *parent1, const Chromosome *parent2,
+                           Chromosome *child1, Chromosome *child2,
+                           float crossover_rate) {
+    if (!parent1 || !parent2 || !child1 || !child2) return;
+
+    const int capacity = parent1->max_moves > parent2->max_moves ?
+                         parent1->max_moves : parent2->max_moves;
+
+    if (!reserve_genes(child1, capacity) || !reserve_genes(child2, capacity)) {
+        printf("❌ Memory allocation error for crossover\n");
+        return;
+    }
+
+    Rng *rng = rng_thread();
+    int shared = crossover_genes(rng, parent1->moves, parent1->num_moves,
+                    parent2->moves, parent2->num_moves,
+                    child1->moves, &child1->num_moves,
+                    child2->moves, &child2->num_moves, crossover_rate);
+
+    child1->start_pos = parent1->start_pos;
+    child2->start_pos = parent2->start_pos;
+    child1->id = (int)rng_bounded(rng, 1000000);
+    child2->id = (int)rng_bounded(rng, 1000000);
+    reset_evaluation(child1);
+    reset_evaluation(child2);
+    
+    // Each child can resume its first parent's trace up to the cut
+    const Chromosome *parents[2] = {parent1, parent2};
+    Chromosome *children[2] = {child1, child2};
+    for (int c = 0; c < 2; c++) {
+        int from = shared < parents[c]->dirty_from ? shared : parents[c]->dirty_from;
+        if (!eval_trace_copy_prefix(&children[c]->trace, parents[c]->trace, from)) {
+            eval_trace_free(children[c]->trace);
+            children[c]->trace = NULL;
+        }
+        children[c]->dirty_from = from;
+    }
+}
+
 // ============= Printing Functions =============
 
 void print_chromosome(const Chromosome *chrom) {
@@ -449,6 +681,195 @@ void print_chromosome_path(const Chromosome *chrom) {
     printf(" → End\n");
 }
 
+// ============= File Functions =============
+// Text header in KEY=VALUE form followed by the packed gene words in hex,
+// one word (21 moves) per line.
+
+static void write_chromosome_record(FILE *file, const Chromosome *chrom) {
+    size_t words = packed_gene_words(chrom->num_moves);
+    uint64_t *packed = (uint64_t*)malloc((words ? words : 1) * sizeof(uint64_t));
+    if (!packed) {
+        printf("❌ Memory allocation error for gene packing\n");
+        return;
+    }
+    pack_genes(chrom->moves, chrom->num_moves, packed);
+
+    fprintf(file, "ID=%d\n", chrom->id);
+    fprintf(file, "START=%d,%d,%d\n", chrom->start_pos.x, chrom->start_pos.y, chrom->start_pos.z);
+    fprintf(file, "MOVES=%d\n", chrom->num_moves);
+    fprintf(file, "MAX_MOVES=%d\n", chrom->max_moves);
+    fprintf(file, "FITNESS=%.4f\n", chrom->fitness);
+    fprintf(file, "GENES=%zu\n", words);
+    for (size_t w = 0; w < words; w++)
+        fprintf(file, "%016llx\n", (unsigned long long)packed[w]);
+
+    free(packed);
+}
+
+void save_chromosome_to_file(const Chromosome *chrom, const char *filename) {
+    if (!chrom || !chrom->moves) return;
+
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        printf("❌ Cannot create file: %s\n", filename);
+        return;
+    }
+
+    fprintf(file, "# Rescue Path Chromosome\n");
+    fprintf(file, "# Genes: 3 bits per move, 21 moves per 64-bit word (hex)\n");
+    write_chromosome_record(file, chrom);
+
+    fclose(file);
+    printf("✅ Chromosome saved to: %s\n", filename);
+}
+
+Chromosome* load_chromosome_from_file(const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        printf("❌ Cannot open file: %s\n", filename);
+        return NULL;
+    }
+
+    char line[256], key[100], value[100];
+    int id = 0, num_moves = -1, max_moves = -1;
+    long words = -1;
+    float fitness = 0.0f;
+    Position start = {0, 0, 0};
+
+    while (words < 0 && fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        if (sscanf(line, "%99[^=]=%99[^\n]", key, value) != 2) continue;
+
+        if (strcmp(key, "ID") == 0) id = atoi(value);
+        else if (strcmp(key, "START") == 0) sscanf(value, "%d,%d,%d", &start.x, &start.y, &start.z);
+        else if (strcmp(key, "MOVES") == 0) num_moves = atoi(value);
+        else if (strcmp(key, "MAX_MOVES") == 0) max_moves = atoi(value);
+        else if (strcmp(key, "FITNESS") == 0) fitness = (float)atof(value);
+        else if (strcmp(key, "GENES") == 0) words = atol(value);
+    }
+
+    if (max_moves < num_moves) max_moves = num_moves;
+    if (num_moves < 0 || words != (long)packed_gene_words(num_moves)) {
+        printf("❌ Invalid chromosome file: %s\n", filename);
+        fclose(file);
+        return NULL;
+    }
+
+    uint64_t *packed = (uint64_t*)malloc((words ? words : 1) * sizeof(uint64_t));
+    Chromosome *chrom = create_chromosome(start, max_moves > 0 ? max_moves : 1);
+    if (!packed || !chrom) {
+        printf("❌ Memory allocation error for chromosome\n");
+        free(packed);
+        free_chromosome(chrom);
+        fclose(file);
+        return NULL;
+    }
+
+    long read = 0;
+    while (read < words && fgets(line, sizeof(line), file)) {
+        char *end;
+        packed[read] = strtoull(line, &end, 16);
+        if (end != line) read++;
+    }
+    fclose(file);
+
+    if (read != words) {
+        printf("❌ Chromosome file truncated: %s\n", filename);
+        free(packed);
+        free_chromosome(chrom);
+        return NULL;
+    }
+
+    unpack_genes(packed, num_moves, chrom->moves);
+    free(packed);
+
+    // Code 7 is not a direction
+    for (int i = 0; i < num_moves; i++) {
+        if (chrom->moves[i] >= MAP_MOVE_COUNT) {
+            printf("⚠️  Invalid move code at %d, replaced by WAIT\n", i);
+            chrom->moves[i] = DIR_WAIT;
+        }
+    }
+
+    chrom->num_moves = num_moves;
+    chrom->id = id;
+    chrom->fitness = fitness;
+    return chrom;
+}
+
+void save_population_to_file(const Population *pop, const char *filename) {
+    if (!pop) return;
+
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        printf("❌ Cannot create file: %s\n", filename);
+        return;
+    }
+
+    fprintf(file, "# Rescue Path Population\n");
+    fprintf(file, "# Genes: 3 bits per move, 21 moves per 64-bit word (hex)\n");
+    fprintf(file, "POPULATION=%d\n", pop->size);
+    fprintf(file, "GENERATION=%d\n", pop->generation);
+
+    for (int i = 0; i < pop->size; i++) {
+        if (!pop->individuals[i].moves) continue;
+        fprintf(file, "\n");
+        write_chromosome_record(file, &pop->individuals[i]);
+    }
+
+    fclose(file);
+    printf("✅ Population saved to: %s\n", filename);
+}
+
+// Only the best `count` are ranked (bounded heap over fitness keys);
+// the population itself is not reordered
+void save_best_chromosomes_to_file(const Population *pop, int count,
+                                   const char *filename) {
+    if (!pop || pop->size <= 0 || count <= 0) return;
+
+    FitnessKey *keys = (FitnessKey*)malloc((size_t)pop->size * sizeof(FitnessKey));
+    FitnessKey *best = (FitnessKey*)malloc((size_t)(count < pop->size ? count : pop->size) * sizeof(FitnessKey));
+    if (!keys || !best) {
+        printf("❌ Memory allocation error for best chromosomes\n");
+        free(keys);
+        free(best);
+        return;
+    }
+
+    int n = 0;
+    for (int i = 0; i < pop->size; i++) {
+        if (!pop->individuals[i].moves) continue;
+        keys[n].fitness = pop->individuals[i].fitness;
+        keys[n].index = i;
+        n++;
+    }
+    n = fitness_keys_top_k(keys, n, count, best);
+
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        printf("❌ Cannot create file: %s\n", filename);
+        free(keys);
+        free(best);
+        return;
+    }
+
+    fprintf(file, "# Best Rescue Paths (best first)\n");
+    fprintf(file, "# Genes: 3 bits per move, 21 moves per 64-bit word (hex)\n");
+    fprintf(file, "POPULATION=%d\n", pop->size);
+    fprintf(file, "GENERATION=%d\n", pop->generation);
+    fprintf(file, "COUNT=%d\n", n);
+
+    for (int k = 0; k < n; k++) {
+        fprintf(file, "\n");
+        write_chromosome_record(file, &pop->individuals[best[k].index]);
+    }
+
+    fclose(file);
+    free(keys);
+    free(best);
+    printf("✅ Best %d chromosomes saved to: %s\n", n, filename);
+}
+
 // ============= Population Functions =============
 
 Population* create_population(int size) {
@@ -465,6 +886,8 @@ Population* create_population(int size) {
     for (int i = 0; i < size; i++) {
         pop->individuals[i].moves = NULL;
         pop->individuals[i].actual_path = NULL;
+        pop->individuals[i].trace = NULL;
+        pop->individuals[i].dirty_from = 0;
     }
     
     pop->size = size;
@@ -473,6 +896,7 @@ Population* create_population(int size) {
     pop->best_fitness = -INFINITY;
     pop->avg_fitness = 0.0f;
     pop->worst_fitness = INFINITY;
+    pop->selection = NULL;
     
     return pop;
 }
@@ -501,13 +925,31 @@ void free_population(Population *pop) {
                 if (pop->individuals[i].actual_path) {
                     free(pop->individuals[i].actual_path);
                 }
+                eval_trace_free(pop->individuals[i].trace);
             }
             free(pop->individuals);
         }
+        selection_tables_free(pop->selection);
         free(pop);
     }
 }
 
+// Chromosomes are independent, so threads split the population; each
+// uses its thread-local workspace and resumes from the chromosome's trace
+void evaluate_population(Population *pop, const Map3D *map,
+                         float w_survivors, float w_coverage,
+                         float w_length, float w_risk) {
+    if (!pop || !map) return;
+
+    #pragma omp parallel for schedule(dynamic, 8)
+    for (int i = 0; i < pop->size; i++) {
+        Chromosome *chrom = &pop->individuals[i];
+        if (!chrom->moves) continue;
+        evaluate_chromosome_incremental(chrom, map, w_survivors, w_coverage,
+                                        w_length, w_risk);
+    }
+}
+
 // ============= Helper Functions =============
 
 const char* direction_to_string(Direction dir) {
@@ -537,7 +979,7 @@ const char* direction_to_symbol(Direction dir) {
 }
 
 Direction get_random_direction() {
-    return (Direction)(rand() % 7); // 7 possible directions
+    return (Direction)rng_bounded(rng_thread(), 7); // 7 possible directions
 }
 
 bool positions_equal(Position p1, Position p2) {
@@ -551,34 +993,18 @@ bool validate_chromosome(const Chromosome *chrom, const Map3D *map) {
         return false;
     }
     
-    Position current = chrom->start_pos;
+    if (!is_valid_position(map, chrom->start_pos)) {
+        return false;
+    }
+    size_t idx = map_pos_index(map, chrom->start_pos);
     
     for (int i = 0; i < chrom->num_moves; i++) {
-        Position next = current;
-        
-        switch (chrom->moves[i]) {
-            case DIR_RIGHT: next.x++; break;
-            case DIR_LEFT: next.x--; break;
-            case DIR_UP: next.y++; break;
-            case DIR_DOWN: next.y--; break;
-            case DIR_FORWARD: next.z++; break;
-            case DIR_BACKWARD: next.z--; break;
-            case DIR_WAIT: break;
-        }
-        
-        // Check map boundaries
-        if (next.x < 0 || next.x >= map->width ||
-            next.y < 0 || next.y >= map->height ||
-            next.z < 0 || next.z >= map->depth) {
-            return false;
-        }
+        idx = map_step(map, idx, move_index(chrom->moves[i]));
         
-        // Check for obstacles
-        if (map->grid[next.x][next.y][next.z] == 1) {
+        // Rubble and the border both block
+        if (map_is_obstacle_at(map, idx)) {
             return false;
         }
-        
-        current = next;
     }
     
     return true;
@@ -597,42 +1023,18 @@ Chromosome* generate_smart_chromosome(Position start, int max_steps, const Map3D
         Direction possible_dirs[7];
         int num_possible = 0;
         
-        // Check each direction
+        // One bitmap mask tells which of the 7 moves land on a free cell
+        unsigned allowed = ~map_blocked_neighbors(map, current, true) & 0x7Fu;
         for (int dir = 0; dir < 7; dir++) {
-            Position test = current;
-            
-            switch (dir) {
-                case DIR_RIGHT: test.x++; break;
-                case DIR_LEFT: test.x--; break;
-                case DIR_UP: test.y++; break;
-                case DIR_DOWN: test.y--; break;
-                case DIR_FORWARD: test.z++; break;
-                case DIR_BACKWARD: test.z--; break;
-                case DIR_WAIT: break;
-            }
-            
-            if (test.x >= 0 && test.x < map->width &&
-                test.y >= 0 && test.y < map->height &&
-                test.z >= 0 && test.z < map->depth &&
-                map->grid[test.x][test.y][test.z] == 0) {
+            if (allowed & (1u << dir)) {
                 possible_dirs[num_possible++] = (Direction)dir;
             }
         }
         
         if (num_possible > 0) {
-            int choice = rand() % num_possible;
+            int choice = (int)rng_bounded(rng_thread(), num_possible);
             chrom->moves[i] = possible_dirs[choice];
-            
-            // Update position
-            switch (chrom->moves[i]) {
-                case DIR_RIGHT: current.x++; break;
-                case DIR_LEFT: current.x--; break;
-                case DIR_UP: current.y++; break;
-                case DIR_DOWN: current.y--; break;
-                case DIR_FORWARD: current.z++; break;
-                case DIR_BACKWARD: current.z--; break;
-                case DIR_WAIT: break;
-            }
+            current = apply_move(current, chrom->moves[i]);
         } else {
             chrom->moves[i] = DIR_WAIT;
         }
@@ -643,81 +1045,83 @@ Chromosome* generate_smart_chromosome(Position start, int max_steps, const Map3D
 
 // ============= Survivor-Focused Chromosome Generator =============
 
+// Walks downhill on the BFS distance fields, so rubble is routed around
+// instead of walked into. The target is the unfinished survivor group
+// closest by walking distance; a group is finished once all of its
+// survivors were detected or its field offers no downhill move. With
+// every group finished the walk heads back to the exit.
 Chromosome* generate_survivor_focused_chromosome(Position start, int max_steps, const Map3D *map) {
+    // The fields are indexed by the start cell, so an off-map start
+    // falls back to the smart generator
+    if (map->survivor_count == 0 || !map->dist_groups || !is_valid_position(map, start)) {
+        return generate_smart_chromosome(start, max_steps, map);
+    }
+    
     Chromosome *chrom = create_chromosome(start, max_steps);
     if (!chrom) return NULL;
     
+    int groups = map->dist_group_count;
+    int *remaining = (int*)calloc(groups, sizeof(int));
+    bool *detected = (bool*)calloc(map->survivor_count, sizeof(bool));
+    if (!remaining || !detected) {
+        free(remaining);
+        free(detected);
+        free_chromosome(chrom);
+        return NULL;
+    }
+    for (int s = 0; s < map->survivor_count; s++) {
+        if (map->survivor_group[s] >= 0) remaining[map->survivor_group[s]]++;
+    }
+    
     chrom->num_moves = max_steps;
     Position current = start;
     
-    if (map->survivor_count == 0) {
-        return generate_smart_chromosome(start, max_steps, map);
-    }
-    
     for (int i = 0; i < max_steps; i++) {
-        int closest_survivor = -1;
-        float min_distance = INFINITY;
+        size_t idx = map_pos_index(map, current);
         
-        for (int s = 0; s < map->survivor_count; s++) {
-            Position survivor_pos = map->survivors[s].pos;
-            float dist = sqrtf(pow(survivor_pos.x - current.x, 2) +
-                              pow(survivor_pos.y - current.y, 2) +
-                              pow(survivor_pos.z - current.z, 2));
-            
-            if (dist < min_distance) {
-                min_distance = dist;
-                closest_survivor = s;
-            }
+        int count;
+        const int32_t *ids = map_detectable_survivors(map, idx, &count);
+        for (int k = 0; k < count; k++) {
+            if (detected[ids[k]]) continue;
+            detected[ids[k]] = true;
+            if (map->survivor_group[ids[k]] >= 0) remaining[map->survivor_group[ids[k]]]--;
         }
         
+        unsigned allowed = ~map_blocked_neighbors(map, current, true) & 0x3Fu;
         Direction best_dir = DIR_WAIT;
-        float best_score = -INFINITY;
         
-        for (int dir = 0; dir < 7; dir++) {
-            Position test = current;
-            
-            switch (dir) {
-                case DIR_RIGHT: test.x++; break;
-                case DIR_LEFT: test.x--; break;
-                case DIR_UP: test.y++; break;
-                case DIR_DOWN: test.y--; break;
-                case DIR_FORWARD: test.z++; break;
-                case DIR_BACKWARD: test.z--; break;
-                case DIR_WAIT: break;
+        for (;;) {
+            int target = -1;
+            uint16_t target_dist = DIST_UNREACHABLE;
+            for (int g = 0; g < groups; g++) {
+                uint16_t d = map_group_distance_field(map, g)[idx];
+                if (remaining[g] > 0 && d < target_dist) {
+                    target_dist = d;
+                    target = g;
+                }
             }
             
-            if (test.x >= 0 && test.x < map->width &&
-                test.y >= 0 && test.y < map->height &&
-                test.z >= 0 && test.z < map->depth &&
-                map->grid[test.x][test.y][test.z] == 0) {
-                
-                Position survivor_pos = map->survivors[closest_survivor].pos;
-                float dist_to_survivor = sqrtf(pow(survivor_pos.x - test.x, 2) +
-                                               pow(survivor_pos.y - test.y, 2) +
-                                               pow(survivor_pos.z - test.z, 2));
-                
-                float score = 1.0f / (dist_to_survivor + 1.0f);
-                
-                if (score > best_score) {
-                    best_score = score;
+            const uint16_t *field = target >= 0 ? map_group_distance_field(map, target) : map->dist_exit;
+            uint16_t best = field[idx];
+            for (unsigned open = allowed; open; open &= open - 1) {
+                int dir = __builtin_ctz(open);
+                uint16_t d = field[map_step(map, idx, dir)];
+                if (d < best) {
+                    best = d;
                     best_dir = (Direction)dir;
                 }
             }
+            
+            if (best_dir != DIR_WAIT || target < 0) break;
+            remaining[target] = 0;
         }
         
         chrom->moves[i] = best_dir;
-        
-        switch (best_dir) {
-            case DIR_RIGHT: current.x++; break;
-            case DIR_LEFT: current.x--; break;
-            case DIR_UP: current.y++; break;
-            case DIR_DOWN: current.y--; break;
-            case DIR_FORWARD: current.z++; break;
-            case DIR_BACKWARD: current.z--; break;
-            case DIR_WAIT: break;
-        }
+        current = apply_move(current, best_dir);
     }
     
+    free(remaining);
+    free(detected);
     return chrom;
 }
 
@@ -0,0 +1,320 @@
+#include "fitness_cache.h"
+#include "prefix_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// CANONICAL GENE KEY
+// ============================================================
+// Walks the moves like the evaluator but only tracks the cell. Moves
+// that bounce off the border become WAIT (a bounce still makes the path
+// invalid, so that is kept as one flag). Codes are shifted so WAIT packs
+// as 0, 21 moves per word, and all-zero words are skipped: trailing
+// WAITs then leave the key unchanged apart from the length, which is
+// mixed in separately because waits still add risk.
+
+static inline void key_add_word(GeneKey *key, uint64_t word, uint64_t index)
+{
+    if (word) gene_key_add_word(key, word, index);
+}
+
+bool gene_key_canonical(const Gene *moves, int num_moves, Position start,
+                        const Map3D *map, GeneKey *key)
+{
+    if (!is_valid_position(map, start)) return false;
+
+    gene_key_init(key);
+
+    size_t idx = map_pos_index(map, start);
+    const size_t start_idx = idx;
+    bool bumped = false;
+    uint64_t word = 0, index = 0;
+    int slot = 0;
+
+    for (int i = 0; i < num_moves; i++)
+    {
+        int m = moves[i] < MAP_MOVE_COUNT ? moves[i] : DIR_WAIT;
+        size_t next = map_step(map, idx, m);
+
+        if (map_cell_at(map, next) == CELL_BORDER)
+        {
+            bumped = true;
+            m = DIR_WAIT;
+        }
+        else
+        {
+            idx = next;
+        }
+
+        word |= (uint64_t)((m + 1) % MAP_MOVE_COUNT) << (GENE_BITS * slot);
+        if (++slot == GENES_PER_WORD)
+        {
+            key_add_word(key, word, index++);
+            word = 0;
+            slot = 0;
+        }
+    }
+    key_add_word(key, word, index);
+
+    uint64_t shape = (uint64_t)num_moves ^ ((uint64_t)start_idx << 24) ^ ((uint64_t)bumped << 63);
+    gene_key_finish(key, shape);
+    return true;
+}
+
+// ============================================================
+// CACHE STORAGE
+// ============================================================
+// Sets of FITNESS_CACHE_WAYS entries; a key maps to one set and sets are
+// spread over the shard locks. When a set is full, a CLOCK hand skips
+// (and clears) recently used entries and evicts the first cold one.
+
+typedef struct {
+    uint64_t lo, hi;
+    float total_length;
+    float total_risk;
+    int32_t survivors_rescued;
+    int32_t coverage_cells;
+    uint8_t valid;
+    uint8_t occupied;
+    uint8_t referenced;
+} CacheEntry;
+
+typedef struct {
+    ShardLock guard;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+    uint64_t evictions;
+} CacheShard;
+
+struct FitnessCache {
+    const Map3D *map;
+    CacheEntry *entries;            // set_count * FITNESS_CACHE_WAYS
+    uint8_t *hands;                 // CLOCK hand per set
+    size_t set_count;               // power of two
+    CacheShard shards[FITNESS_CACHE_SHARDS];
+};
+
+FitnessCache* fitness_cache_create(size_t entries, const Map3D *map)
+{
+    if (!map) return NULL;
+
+    size_t sets = 1;
+    while (sets * FITNESS_CACHE_WAYS < entries) sets <<= 1;
+
+    FitnessCache *cache = (FitnessCache *)sharded_cache_alloc(sizeof(FitnessCache));
+    if (!cache)
+    {
+        printf("❌ Memory allocation error for fitness cache\n");
+        return NULL;
+    }
+
+    cache->map = map;
+    cache->set_count = sets;
+    cache->entries = (CacheEntry *)calloc(sets * FITNESS_CACHE_WAYS, sizeof(CacheEntry));
+    cache->hands = (uint8_t *)calloc(sets, 1);
+    if (!cache->entries || !cache->hands)
+    {
+        printf("❌ Memory allocation error for fitness cache\n");
+        free(cache->entries);
+        free(cache->hands);
+        free(cache);
+        return NULL;
+    }
+
+    shard_locks_init(cache->shards, sizeof(cache->shards[0]), FITNESS_CACHE_SHARDS);
+
+    return cache;
+}
+
+void fitness_cache_free(FitnessCache *cache)
+{
+    if (!cache) return;
+
+    shard_locks_destroy(cache->shards, sizeof(cache->shards[0]), FITNESS_CACHE_SHARDS);
+    free(cache->entries);
+    free(cache->hands);
+    free(cache);
+}
+
+void fitness_cache_clear(FitnessCache *cache)
+{
+    if (!cache) return;
+
+    memset(cache->entries, 0, cache->set_count * FITNESS_CACHE_WAYS * sizeof(CacheEntry));
+    memset(cache->hands, 0, cache->set_count);
+    for (int s = 0; s < FITNESS_CACHE_SHARDS; s++)
+    {
+        CacheShard *shard = &cache->shards[s];
+        shard->hits = shard->misses = shard->insertions = shard->evictions = 0;
+    }
+}
+
+static inline size_t cache_set_of(const FitnessCache *cache, GeneKey key)
+{
+    return (size_t)key.lo & (cache->set_count - 1);
+}
+
+bool fitness_cache_lookup(FitnessCache *cache, GeneKey key, PathMetrics *out)
+{
+    size_t set = cache_set_of(cache, key);
+    CacheShard *shard = &cache->shards[set % FITNESS_CACHE_SHARDS];
+    CacheEntry *ways = &cache->entries[set * FITNESS_CACHE_WAYS];
+    bool found = false;
+
+    shard_lock(&shard->guard);
+    for (int w = 0; w < FITNESS_CACHE_WAYS; w++)
+    {
+        CacheEntry *e = &ways[w];
+        if (e->occupied && e->lo == key.lo && e->hi == key.hi)
+        {
+            e->referenced = 1;
+            out->survivors_rescued = e->survivors_rescued;
+            out->coverage_cells = e->coverage_cells;
+            out->total_length = e->total_length;
+            out->total_risk = e->total_risk;
+            out->valid = e->valid;
+            found = true;
+            break;
+        }
+    }
+    if (found) shard->hits++;
+    else shard->misses++;
+    shard_unlock(&shard->guard);
+
+    return found;
+}
+
+void fitness_cache_insert(FitnessCache *cache, GeneKey key, const PathMetrics *metrics)
+{
+    size_t set = cache_set_of(cache, key);
+    CacheShard *shard = &cache->shards[set % FITNESS_CACHE_SHARDS];
+    CacheEntry *ways = &cache->entries[set * FITNESS_CACHE_WAYS];
+    CacheEntry *slot = NULL;
+
+    shard_lock(&shard->guard);
+
+    // Already there (another thread got it first) or a free way
+    for (int w = 0; w < FITNESS_CACHE_WAYS && !slot; w++)
+        if (ways[w].occupied && ways[w].lo == key.lo && ways[w].hi == key.hi)
+            slot = &ways[w];
+    for (int w = 0; w < FITNESS_CACHE_WAYS && !slot; w++)
+        if (!ways[w].occupied)
+            slot = &ways[w];
+
+    if (!slot)
+    {
+        uint8_t hand = cache->hands[set];
+        while (ways[hand].referenced)
+        {
+            ways[hand].referenced = 0;
+            hand = (hand + 1) % FITNESS_CACHE_WAYS;
+        }
+        slot = &ways[hand];
+        cache->hands[set] = (hand + 1) % FITNESS_CACHE_WAYS;
+        shard->evictions++;
+    }
+
+    if (!slot->occupied || slot->lo != key.lo || slot->hi != key.hi) shard->insertions++;
+    slot->lo = key.lo;
+    slot->hi = key.hi;
+    slot->survivors_rescued = metrics->survivors_rescued;
+    slot->coverage_cells = metrics->coverage_cells;
+    slot->total_length = metrics->total_length;
+    slot->total_risk = metrics->total_risk;
+    slot->valid = metrics->valid;
+    slot->occupied = 1;
+    slot->referenced = 0;
+
+    shard_unlock(&shard->guard);
+}
+
+// ============================================================
+// CACHED EVALUATION
+// ============================================================
+
+bool evaluate_path_cached(const Gene *moves, int num_moves, Position start,
+                          const Map3D *map, EvalWorkspace *ws,
+                          FitnessCache *cache, PrefixCache *prefixes,
+                          float w_survivors, float w_coverage,
+                          float w_length, float w_risk, PathMetrics *out)
+{
+    GeneKey key;
+    if (!cache || cache->map != map || !gene_key_canonical(moves, num_moves, start, map, &key))
+        return evaluate_path_prefixed(moves, num_moves, start, map, ws, prefixes,
+                                      w_survivors, w_coverage, w_length, w_risk, out);
+
+    if (fitness_cache_lookup(cache, key, out))
+    {
+        out->fitness = (w_survivors * out->survivors_rescued) + (w_coverage * out->coverage_cells) -
+                       (w_length * out->total_length) - (w_risk * out->total_risk);
+        out->time_estimate = out->total_length * 0.5f;
+        return true;
+    }
+
+    if (!evaluate_path_prefixed(moves, num_moves, start, map, ws, prefixes,
+                                w_survivors, w_coverage, w_length, w_risk, out))
+        return false;
+
+    fitness_cache_insert(cache, key, out);
+    return true;
+}
+
+float evaluate_chromosome_cached(Chromosome *chrom, const Map3D *map, FitnessCache *cache,
+                                 float w_survivors, float w_coverage,
+                                 float w_length, float w_risk)
+{
+    PathMetrics metrics;
+    evaluate_path_cached(chrom->moves, chrom->num_moves, chrom->start_pos, map,
+                         eval_workspace_thread(map), cache, NULL,
+                         w_survivors, w_coverage, w_length, w_risk, &metrics);
+
+    chrom->fitness = metrics.fitness;
+    chrom->survivors_rescued = metrics.survivors_rescued;
+    chrom->coverage_cells = metrics.coverage_cells;
+    chrom->total_length = metrics.total_length;
+    chrom->total_risk = metrics.total_risk;
+    chrom->time_estimate = metrics.time_estimate;
+    chrom->valid = metrics.valid;
+
+    free(chrom->actual_path);
+    chrom->actual_path = NULL;
+    chrom->actual_path_length = 0;
+
+    return chrom->fitness;
+}
+
+// ============================================================
+// STATISTICS
+// ============================================================
+
+void fitness_cache_get_stats(const FitnessCache *cache, FitnessCacheStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (!cache) return;
+
+    stats->capacity = cache->set_count * FITNESS_CACHE_WAYS;
+    for (int s = 0; s < FITNESS_CACHE_SHARDS; s++)
+    {
+        CacheShard *shard = (CacheShard *)&cache->shards[s];
+        shard_lock(&shard->guard);
+        stats->hits += shard->hits;
+        stats->misses += shard->misses;
+        stats->insertions += shard->insertions;
+        stats->evictions += shard->evictions;
+        shard_unlock(&shard->guard);
+    }
+}
+
+void fitness_cache_print_stats(const FitnessCache *cache)
+{
+    FitnessCacheStats stats;
+    fitness_cache_get_stats(cache, &stats);
+
+    uint64_t lookups = stats.hits + stats.misses;
+    printf("🗃️  Fitness cache: %llu hits / %llu lookups (%.1f%%), %llu evictions, %zu entries\n",
+           (unsigned long long)stats.hits, (unsigned long long)lookups,
+           lookups ? 100.0 * stats.hits / lookups : 0.0,
+           (unsigned long long)stats.evictions, stats.capacity);
+}
@@ -0,0 +1,260 @@
+#include "ga.h"
+#include "selection.h"
+#include "ranking.h"
+#include "prefix_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+
+// ============================================================
+// GENERATION STEP
+// ============================================================
+// Elites are copied with their scores and skip evaluation; the other
+// slots are filled with pairs of children. Pairs are bred in chunks of
+// GA_BREED_CHUNK, each with its own stream derived from the seed and the
+// generation, so results do not depend on the thread count.
+
+static void ga_breed(const PopulationArena *cur, PopulationArena *next, int elites, int32_t *order,
+                     const Settings *settings, uint64_t seed, int generation)
+{
+    const int size = cur->size;
+    const int tournament = settings->tournament_size > 0 ? settings->tournament_size : 1;
+
+    if (elites > 0)
+    {
+        fitness_select_top(cur->fitness, size, elites, order);
+        for (int e = 0; e < elites; e++)
+            arena_copy_individual(next, e, cur, order[e]);
+    }
+
+    const int pairs = (size - elites + 1) / 2;
+    const int chunks = (pairs + GA_BREED_CHUNK - 1) / GA_BREED_CHUNK;
+    const uint64_t generation_seed = seed ^ rng_mix64((uint64_t)generation);
+
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < chunks; c++)
+    {
+        Rng rng;
+        rng_seed(&rng, generation_seed, RNG_STREAM_POPULATION + (uint64_t)c);
+
+        int last = (c + 1) * GA_BREED_CHUNK < pairs ? (c + 1) * GA_BREED_CHUNK : pairs;
+        for (int p = c * GA_BREED_CHUNK; p < last; p++)
+        {
+            int c1 = elites + 2 * p, c2 = c1 + 1;
+            int p1 = tournament_select_index(&rng, cur->fitness, size, tournament);
+            int p2 = tournament_select_index(&rng, cur->fitness, size, tournament);
+
+            if (c2 < size)
+            {
+                arena_crossover(&rng, cur, p1, p2, next, c1, c2, settings->crossover_rate);
+                arena_mutate(&rng, next, c1, settings->mutation_rate);
+                arena_mutate(&rng, next, c2, settings->mutation_rate);
+            }
+            else
+            {
+                // Odd slot left over: a mutated copy of one winner
+                arena_copy_individual(next, c1, cur, p1);
+                arena_mutate(&rng, next, c1, settings->mutation_rate);
+            }
+        }
+    }
+}
+
+// Best index plus mean and worst fitness in one pass
+static int ga_generation_stats(const PopulationArena *arena, float *avg, float *worst)
+{
+    int best = 0;
+    double sum = 0.0;
+    float low = arena->fitness[0];
+
+    for (int i = 0; i < arena->size; i++)
+    {
+        float f = arena->fitness[i];
+        sum += f;
+        if (f > arena->fitness[best]) best = i;
+        if (f < low) low = f;
+    }
+
+    *avg = (float)(sum / arena->size);
+    *worst = low;
+    return best;
+}
+
+// Expected share of a child's prefix blocks that match a parent: block
+// j (genes [0, 64j)) is reusable when none of its genes mutated and the
+// crossover point, if any, lies after it
+static double ga_prefix_reuse(const Settings *settings, int max_moves)
+{
+    const int blocks = max_moves / PREFIX_BLOCK_MOVES;
+    if (blocks < 1) return 0.0;
+
+    const double intact = pow(1.0 - settings->mutation_rate, PREFIX_BLOCK_MOVES);
+    double survive = 1.0, sum = 0.0;
+    for (int j = 1; j <= blocks; j++)
+    {
+        survive *= intact;
+        double before_cut = 1.0 - settings->crossover_rate * (double)j / blocks;
+        sum += survive * before_cut;
+    }
+    return sum / blocks;
+}
+
+// ============================================================
+// ENGINE
+// ============================================================
+
+GAResult *run_ga(const Settings *settings, const Map3D *map)
+{
+    if (!settings || !map) return NULL;
+
+    const int size = settings->population_size;
+    const int max_moves = settings->max_path_length;
+    if (size < 2 || max_moves < 1 || settings->generations < 0)
+    {
+        printf("❌ Invalid GA settings: population %d, path length %d, generations %d\n",
+               size, max_moves, settings->generations);
+        return NULL;
+    }
+
+    int elites = (int)(settings->elitism_rate * size);
+    if (elites < 0) elites = 0;
+    if (elites > size) elites = size;
+
+    if (settings->num_workers > 0) omp_set_num_threads(settings->num_workers);
+
+    // Children are exact copies when neither crossover nor any mutation
+    // hits; only then is the fitness cache worth its lookups
+    const double repeats = (1.0 - settings->crossover_rate) *
+                           pow(1.0 - settings->mutation_rate, max_moves);
+
+    GAResult *result = (GAResult *)calloc(1, sizeof(GAResult));
+    GenerationArenas *gens = create_generation_arenas(size, max_moves, map);
+    int32_t *order = (int32_t *)malloc(size * sizeof(int32_t));
+    FitnessCache *cache = repeats >= GA_CACHE_MIN_REPEATS
+        ? fitness_cache_create(FITNESS_CACHE_DEFAULT_ENTRIES, map) : NULL;
+    PrefixCache *prefixes = ga_prefix_reuse(settings, max_moves) >= GA_PREFIX_MIN_REUSE
+        ? prefix_cache_create((int)((long long)size * max_moves / PREFIX_BLOCK_MOVES), map) : NULL;
+
+    if (!result || !gens || !order)
+    {
+        printf("❌ Memory allocation error for genetic algorithm\n");
+        free(result);
+        free_generation_arenas(gens);
+        free(order);
+        fitness_cache_free(cache);
+        prefix_cache_free(prefixes);
+        return NULL;
+    }
+    result->best = create_chromosome(map->start_position, max_moves);
+    if (!result->best)
+    {
+        printf("❌ Memory allocation error for genetic algorithm\n");
+        free_ga_result(result);
+        free_generation_arenas(gens);
+        free(order);
+        fitness_cache_free(cache);
+        prefix_cache_free(prefixes);
+        return NULL;
+    }
+
+    const float w_s = settings->w_survivors, w_c = settings->w_coverage;
+    const float w_l = settings->w_length, w_r = settings->w_risk;
+    const uint64_t seed = rng_global_seed();
+
+    if (settings->log_level > 0)
+    {
+        printf("\n🧬 Genetic algorithm: %d individuals × %d moves, %d generations, %d elites, %d threads%s%s\n",
+               size, max_moves, settings->generations, elites, gens->workspace_count,
+               cache ? ", fitness cache" : "", prefixes ? ", prefix cache" : "");
+        printf("--------------------------------------------------------------------\n");
+    }
+
+    const double t_start = omp_get_wtime();
+
+    // Generation 0
+    PopulationArena *cur = generation_current(gens);
+    arena_randomize(cur, map->start_position);
+    arena_evaluate(cur, 0, size, map, gens->workspaces, gens->workspace_count, cache, prefixes,
+                   w_s, w_c, w_l, w_r);
+
+    float avg, worst;
+    int best = ga_generation_stats(cur, &avg, &worst);
+    arena_load_chromosome(cur, best, result->best);
+    result->best_fitness = cur->fitness[best];
+    result->best_generation = 0;
+
+    for (int g = 1; g <= settings->generations; g++)
+    {
+        const double t0 = omp_get_wtime();
+        cur = generation_current(gens);
+        PopulationArena *next = generation_next(gens);
+        ga_breed(cur, next, elites, order, settings, seed, g);
+
+        const double t1 = omp_get_wtime();
+        prefix_cache_begin_generation(prefixes);
+        arena_evaluate(next, elites, size - elites, map, gens->workspaces, gens->workspace_count,
+                       cache, prefixes, w_s, w_c, w_l, w_r);
+        const double t2 = omp_get_wtime();
+
+        generation_arenas_swap(gens);
+        cur = generation_current(gens);
+        best = ga_generation_stats(cur, &avg, &worst);
+        if (cur->fitness[best] > result->best_fitness)
+        {
+            arena_load_chromosome(cur, best, result->best);
+            result->best_fitness = cur->fitness[best];
+            result->best_generation = g;
+        }
+
+        result->breed_seconds += t1 - t0;
+        result->eval_seconds += t2 - t1;
+        if (t2 - t0 > result->slowest_generation) result->slowest_generation = t2 - t0;
+        result->generations = g;
+
+        if (settings->log_level > 0)
+        {
+            printf("Gen %4d | best %10.3f | avg %10.3f | worst %10.3f | breed %7.3f ms | eval %7.3f ms\n",
+                   g, cur->fitness[best], avg, worst, (t1 - t0) * 1e3, (t2 - t1) * 1e3);
+        }
+    }
+
+    result->total_seconds = omp_get_wtime() - t_start;
+
+    if (cache && settings->log_level > 0) fitness_cache_print_stats(cache);
+    if (prefixes && settings->log_level > 0) prefix_cache_print_stats(prefixes);
+
+    fitness_cache_free(cache);
+    prefix_cache_free(prefixes);
+    free(order);
+    free_generation_arenas(gens);
+    return result;
+}
+
+void print_ga_result(const GAResult *result)
+{
+    if (!result) return;
+
+    printf("\n════════════════════════════════════════════════════════════════\n");
+    printf("                     GENETIC ALGORITHM RESULT\n");
+    printf("════════════════════════════════════════════════════════════════\n");
+    printf("Generations: %d (best found in generation %d)\n", result->generations, result->best_generation);
+    printf("Total time: %.3f s\n", result->total_seconds);
+    if (result->generations > 0)
+    {
+        printf("Per generation: %.3f ms avg (breed %.3f ms, eval %.3f ms), slowest %.3f ms\n",
+               (result->breed_seconds + result->eval_seconds) / result->generations * 1e3,
+               result->breed_seconds / result->generations * 1e3,
+               result->eval_seconds / result->generations * 1e3,
+               result->slowest_generation * 1e3);
+    }
+    if (result->best) print_chromosome(result->best);
+}
+
+void free_ga_result(GAResult *result)
+{
+    if (!result) return;
+    free_chromosome(result->best);
+    free(result);
+}
@@ -3,8 +3,17 @@
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include "map_loader.h"
 #include "chromosome.h"
+#include "map_io.h"
+#include "benchmark.h"
+#include "ga.h"
+#include "rng.h"
+
+// Saved map locations (draw-map.py reads the text file)
+#define MAP_TEXT_FILE "data/saved_map.txt"
+#define MAP_SNAPSHOT_FILE "data/saved_map.rsm"
 
 // Robot definition
 typedef struct
@@ -38,8 +47,12 @@ void print_menu()
     printf("║ 2. 🗺️  Create new map                             ║\n");
     printf("║ 3. 🚀 generate_and_print_10_chromosomes           ║\n");
     printf("║ 4. ❌ Exit                                        ║\n");
+    printf("║ 5. 💾 Save map (text + binary snapshot)           ║\n");
+    printf("║ 6. 📥 Load map snapshot                           ║\n");
+    printf("║ 7. ⏱️  Run performance benchmarks                  ║\n");
+    printf("║ 8. 🧬 Run genetic algorithm                       ║\n");
     printf("╚════════════════════════════════════════════════════╝\n");
-    printf("Please choose an option (1-4): ");
+    printf("Please choose an option (1-8): ");
 }
 
 // Function to free simulation result memory
@@ -261,6 +274,9 @@ int main(int argc, char *argv[])
     int choice;
     char input[100];
 
+    // Saved maps and benchmark files go under data/
+    mkdir("data", 0755);
+
     do
     {
         print_menu();
@@ -281,6 +297,10 @@ int main(int argc, char *argv[])
                 if (settings)
                 {
                   //  print_settings(settings);
+                    if (settings->seed == 0)
+                        settings->seed = (unsigned long long)time(NULL);
+                    rng_set_global_seed(settings->seed);
+                    printf("🎲 Random seed: %llu\n", settings->seed);
                     printf("✅ Settings loaded successfully.\n");
                 }
                 else
@@ -303,15 +323,16 @@ int main(int argc, char *argv[])
                 }
                 
                 printf("\n🧱 Creating new map...\n");
-                map = create_map(settings->map_width,
-                                 settings->map_height,
-                                 settings->map_depth);
+                map = create_map_with_layout(settings->map_width,
+                                             settings->map_height,
+                                             settings->map_depth,
+                                             settings->map_layout);
 
                 if (map)
                 {
+                    map_set_start_position(map, settings->robot_start);
                     initialize_map(map, settings->obstacle_ratio,
                                    settings->survivor_ratio);
-                    map->start_position = settings->robot_start;
                     
                     printf("\n✅ New map created successfully!\n");
                     printf("   Dimensions: %d × %d × %d\n", 
@@ -342,8 +363,55 @@ int main(int argc, char *argv[])
                 printf("════════════════════════════════════════════════════════════\n");
                 break;
 
+            case 5: // Save map
+                if (!map)
+                {
+                    printf("⚠️ Please create a map first (Option 2)\n");
+                    break;
+                }
+                save_map_to_file(map, MAP_TEXT_FILE);
+                save_map_snapshot(map, MAP_SNAPSHOT_FILE);
+                break;
+
+            case 6: // Load map snapshot
+                if (map)
+                {
+                    free_map(map);
+                    map = NULL;
+                }
+                map = load_map_mmap(MAP_SNAPSHOT_FILE);
+                if (!map)
+                {
+                    printf("❌ Failed to load map snapshot.\n");
+                }
+                break;
+
+            case 7: // Benchmarks
+                run_benchmarks(map);
+                break;
+
+            case 8: // Genetic algorithm
+                if (!settings || !map)
+                {
+                    printf("⚠️ Please load settings and create a map first (Options 1, 2)\n");
+                    break;
+                }
+                {
+                    GAResult *ga = run_ga(settings, map);
+                    if (ga)
+                    {
+                        print_ga_result(ga);
+                        free_ga_result(ga);
+                    }
+                    else
+                    {
+                        printf("❌ Genetic algorithm failed.\n");
+                    }
+                }
+                break;
+
             default:
-                printf("❌ Invalid choice. Please enter a number between 1-6.\n");
+                printf("❌ Invalid choice. Please enter a number between 1-8.\n");
             }
         }
         
@@ -0,0 +1,183 @@
+#include "map_bricks.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// SPARSE BRICK STORAGE
+// ============================================================
+// Collapsed structures are mostly solid rubble or open void. Cells are
+// grouped into 8x8x8 bricks; a brick whose cells all hold the same code
+// keeps only that byte, and its 512-byte payload is allocated on the
+// first write that breaks the uniformity. Memory therefore follows the
+// rubble/void boundary instead of the volume.
+
+MapBricks *map_bricks_create(int width, int height, int depth)
+{
+    MapBricks *bricks = (MapBricks *)calloc(1, sizeof(MapBricks));
+    if (!bricks) return NULL;
+
+    bricks->bricks_x = (width + MAP_BRICK_MASK) >> MAP_BRICK_SHIFT;
+    bricks->bricks_y = (height + MAP_BRICK_MASK) >> MAP_BRICK_SHIFT;
+    bricks->bricks_z = (depth + MAP_BRICK_MASK) >> MAP_BRICK_SHIFT;
+    bricks->brick_count = (size_t)bricks->bricks_x * bricks->bricks_y * bricks->bricks_z;
+
+    bricks->uniform = (uint8_t *)calloc(bricks->brick_count ? bricks->brick_count : 1, 1);
+    bricks->data = (uint8_t **)calloc(bricks->brick_count ? bricks->brick_count : 1, sizeof(uint8_t *));
+    if (!bricks->uniform || !bricks->data) {
+        printf("❌ Memory allocation error for brick table\n");
+        map_bricks_free(bricks);
+        return NULL;
+    }
+
+    return bricks;
+}
+
+void map_bricks_free(MapBricks *bricks)
+{
+    if (!bricks) return;
+
+    if (bricks->data) {
+        for (size_t b = 0; b < bricks->brick_count; b++)
+            free(bricks->data[b]);
+    }
+    free(bricks->data);
+    free(bricks->uniform);
+    free(bricks);
+}
+
+// Writes that keep a uniform brick uniform cost nothing
+bool map_brick_set(MapBricks *bricks, int x, int y, int z, uint8_t type)
+{
+    size_t b = map_brick_id(bricks, x, y, z);
+    uint8_t *data = bricks->data[b];
+
+    if (!data) {
+        if (bricks->uniform[b] == type) return true;
+
+        data = (uint8_t *)aligned_alloc(MAP_CACHE_LINE, MAP_BRICK_CELLS);
+        if (!data) {
+            printf("❌ Memory allocation error for map brick\n");
+            return false;
+        }
+        memset(data, bricks->uniform[b], MAP_BRICK_CELLS);
+        bricks->data[b] = data;
+        bricks->allocated++;
+    }
+
+    data[map_brick_offset(x, y, z)] = type;
+    return true;
+}
+
+// The border is not stored in bricks; it is synthesised on read
+uint8_t map_brick_cell_at(const Map3D *map, size_t idx)
+{
+    Position pos = map_index_to_position(map, idx);
+    if (!is_valid_position(map, pos)) return CELL_BORDER;
+    return map_brick_cell_xyz(map->bricks, pos.x, pos.y, pos.z);
+}
+
+// Walks the floors row by row; runs inside a uniform brick are counted
+// without touching individual cells
+size_t map_bricks_count_cells(const Map3D *map, int z_first, int z_count, uint8_t type)
+{
+    const MapBricks *bricks = map->bricks;
+    size_t total = 0;
+
+    for (int z = z_first; z < z_first + z_count; z++) {
+        for (int y = 0; y < map->height; y++) {
+            for (int x = 0; x < map->width; ) {
+                int run = MAP_BRICK_DIM - (x & MAP_BRICK_MASK);
+                if (run > map->width - x) run = map->width - x;
+
+                size_t b = map_brick_id(bricks, x, y, z);
+                const uint8_t *data = bricks->data[b];
+                if (!data) {
+                    if (bricks->uniform[b] == type) total += (size_t)run;
+                } else {
+                    const uint8_t *cell = &data[map_brick_offset(x, y, z)];
+                    for (int i = 0; i < run; i++)
+                        total += cell[i] == type;
+                }
+                x += run;
+            }
+        }
+    }
+
+    return total;
+}
+
+// Only cells inside the map count; border bricks keep padding that
+// is never written
+static bool brick_is_uniform(const Map3D *map, size_t b, const uint8_t *data)
+{
+    const MapBricks *bricks = map->bricks;
+    size_t layer_size = (size_t)bricks->bricks_x * bricks->bricks_y;
+    int bx = (int)(b % bricks->bricks_x);
+    int by = (int)(b / bricks->bricks_x % bricks->bricks_y);
+    int bz = (int)(b / layer_size);
+    int nx = map->width - (bx << MAP_BRICK_SHIFT);
+    int ny = map->height - (by << MAP_BRICK_SHIFT);
+    int nz = map->depth - (bz << MAP_BRICK_SHIFT);
+
+    // A full brick is uniform when it equals itself shifted by one byte
+    if (nx >= MAP_BRICK_DIM && ny >= MAP_BRICK_DIM && nz >= MAP_BRICK_DIM)
+        return memcmp(data, data + 1, MAP_BRICK_CELLS - 1) == 0;
+
+    if (nx > MAP_BRICK_DIM) nx = MAP_BRICK_DIM;
+    if (ny > MAP_BRICK_DIM) ny = MAP_BRICK_DIM;
+    if (nz > MAP_BRICK_DIM) nz = MAP_BRICK_DIM;
+    for (int z = 0; z < nz; z++)
+        for (int y = 0; y < ny; y++)
+            for (int x = 0; x < nx; x++)
+                if (data[map_brick_offset(x, y, z)] != data[0]) return false;
+    return true;
+}
+
+// Folds allocated bricks whose cells ended up identical back into a
+// single byte. Loaders call this as they finish each layer of bricks.
+size_t map_compact_bricks(Map3D *map, int first_layer, int layer_count)
+{
+    MapBricks *bricks = map ? map->bricks : NULL;
+    if (!bricks) return 0;
+
+    int last_layer = first_layer + layer_count;
+    if (first_layer < 0) first_layer = 0;
+    if (last_layer > bricks->bricks_z) last_layer = bricks->bricks_z;
+    if (first_layer >= last_layer) return 0;
+
+    size_t layer_size = (size_t)bricks->bricks_x * bricks->bricks_y;
+    size_t begin = (size_t)first_layer * layer_size;
+    size_t end = (size_t)last_layer * layer_size;
+    size_t freed = 0;
+
+    #pragma omp parallel for schedule(dynamic, 256) reduction(+:freed)
+    for (size_t b = begin; b < end; b++) {
+        uint8_t *data = bricks->data[b];
+        if (!data) continue;
+
+        if (brick_is_uniform(map, b, data)) {
+            bricks->uniform[b] = data[0];
+            bricks->data[b] = NULL;
+            free(data);
+            freed++;
+        }
+    }
+
+    bricks->allocated -= freed;
+    return freed;
+}
+
+size_t map_storage_bytes(const Map3D *map)
+{
+    if (!map) return 0;
+
+    if (map->bricks) {
+        const MapBricks *bricks = map->bricks;
+        return sizeof(MapBricks) +
+               bricks->brick_count * (sizeof(uint8_t) + sizeof(uint8_t *)) +
+               bricks->allocated * MAP_BRICK_CELLS;
+    }
+
+    return map->cell_count + 2 * (map->bitmap_words + 1) * sizeof(uint64_t);
+}
@@ -0,0 +1,240 @@
+#include "map_components.h"
+#include "map_fields.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// CONNECTED COMPONENTS OF FREE SPACE
+// ============================================================
+// Every row is split into runs of passable cells (anything but rubble).
+// Runs are joined with a union-find: first with overlapping runs of the
+// previous row of the same floor, which floors do independently and in
+// parallel, then with overlapping runs of the floor below. No per-cell
+// label array is needed; a cell's component is the root of its run.
+
+typedef struct {
+    int x0, x1;                  // inclusive span along x
+} CellRun;
+
+typedef struct {
+    CellRun *runs;
+    uint32_t *parent;
+    size_t *row_first;           // runs of row r: [row_first[r], row_first[r + 1])
+    size_t run_count;
+} RunForest;
+
+static inline uint32_t run_find(uint32_t *parent, uint32_t run)
+{
+    while (parent[run] != run) {
+        parent[run] = parent[parent[run]];   // path halving
+        run = parent[run];
+    }
+    return run;
+}
+
+static inline void run_union(uint32_t *parent, uint32_t a, uint32_t b)
+{
+    a = run_find(parent, a);
+    b = run_find(parent, b);
+    if (a < b) parent[b] = a;
+    else if (b < a) parent[a] = b;
+}
+
+// Joins every pair of x-overlapping runs between two rows
+static void union_rows(RunForest *forest, size_t row_a, size_t row_b)
+{
+    size_t i = forest->row_first[row_a], i_end = forest->row_first[row_a + 1];
+    size_t j = forest->row_first[row_b], j_end = forest->row_first[row_b + 1];
+
+    while (i < i_end && j < j_end) {
+        const CellRun *a = &forest->runs[i];
+        const CellRun *b = &forest->runs[j];
+
+        if (a->x0 <= b->x1 && b->x0 <= a->x1)
+            run_union(forest->parent, (uint32_t)i, (uint32_t)j);
+
+        if (a->x1 < b->x1) i++;
+        else j++;
+    }
+}
+
+// Scans one row; writes runs when out is non-NULL, returns their count
+static size_t scan_row(const Map3D *map, int y, int z, CellRun *out)
+{
+    size_t idx = map_index(map, 0, y, z);
+    size_t count = 0;
+    int x = 0;
+
+    while (x < map->width) {
+        while (x < map->width && map_is_obstacle_at(map, idx)) {
+            x++;
+            idx = map_step(map, idx, MAP_MOVE_NEXT_X);
+        }
+        if (x == map->width) break;
+
+        int start = x;
+        while (x < map->width && !map_is_obstacle_at(map, idx)) {
+            x++;
+            idx = map_step(map, idx, MAP_MOVE_NEXT_X);
+        }
+        if (out) {
+            out[count].x0 = start;
+            out[count].x1 = x - 1;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+static bool build_run_forest(const Map3D *map, RunForest *forest)
+{
+    size_t rows = (size_t)map->height * map->depth;
+    memset(forest, 0, sizeof(*forest));
+
+    forest->row_first = (size_t *)calloc(rows + 1, sizeof(size_t));
+    if (!forest->row_first) return false;
+
+    const int height = map->height;
+    const int depth = map->depth;
+
+    #pragma omp parallel for schedule(static)
+    for (int z = 0; z < depth; z++)
+        for (int y = 0; y < height; y++)
+            forest->row_first[(size_t)z * height + y + 1] = scan_row(map, y, z, NULL);
+
+    for (size_t r = 0; r < rows; r++)
+        forest->row_first[r + 1] += forest->row_first[r];
+    forest->run_count = forest->row_first[rows];
+
+    if (forest->run_count >= UINT32_MAX) return false;
+
+    forest->runs = (CellRun *)malloc((forest->run_count ? forest->run_count : 1) * sizeof(CellRun));
+    forest->parent = (uint32_t *)malloc((forest->run_count ? forest->run_count : 1) * sizeof(uint32_t));
+    if (!forest->runs || !forest->parent) return false;
+
+    // Fill runs and join rows within each floor; floors touch disjoint runs
+    #pragma omp parallel for schedule(dynamic)
+    for (int z = 0; z < depth; z++) {
+        for (int y = 0; y < height; y++) {
+            size_t row = (size_t)z * height + y;
+            scan_row(map, y, z, &forest->runs[forest->row_first[row]]);
+            for (size_t r = forest->row_first[row]; r < forest->row_first[row + 1]; r++)
+                forest->parent[r] = (uint32_t)r;
+            if (y > 0) union_rows(forest, row, row - 1);
+        }
+    }
+
+    // Join each floor to the one below
+    for (int z = 1; z < depth; z++)
+        for (int y = 0; y < height; y++)
+            union_rows(forest, (size_t)z * height + y, (size_t)(z - 1) * height + y);
+
+    return true;
+}
+
+static void free_run_forest(RunForest *forest)
+{
+    free(forest->runs);
+    free(forest->parent);
+    free(forest->row_first);
+}
+
+// Run holding (x, y, z), or -1 for rubble
+static long find_run(const Map3D *map, const RunForest *forest, int x, int y, int z)
+{
+    size_t row = (size_t)z * map->height + y;
+    size_t lo = forest->row_first[row], hi = forest->row_first[row + 1];
+
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (forest->runs[mid].x1 < x) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if (lo < forest->row_first[row + 1] && forest->runs[lo].x0 <= x)
+        return (long)lo;
+    return -1;
+}
+
+bool map_label_components(Map3D *map)
+{
+    if (!map) return false;
+
+    map_release_buffer(map, map->survivor_reachable);
+    map->survivor_reachable = NULL;
+    memset(&map->components, 0, sizeof(map->components));
+
+    RunForest forest;
+    memset(&forest, 0, sizeof(forest));
+    uint8_t *reachable = (uint8_t *)malloc(map->survivor_count > 0 ? (size_t)map->survivor_count : 1);
+    if (!reachable || !build_run_forest(map, &forest)) {
+        printf("❌ Memory allocation error for component labelling\n");
+        free(reachable);
+        free_run_forest(&forest);
+        return false;
+    }
+
+    Position start = map->start_position;
+    long start_run = find_run(map, &forest, start.x, start.y, start.z);
+    uint32_t start_root = start_run >= 0 ? run_find(forest.parent, (uint32_t)start_run) : UINT32_MAX;
+
+    for (size_t r = 0; r < forest.run_count; r++) {
+        uint32_t root = run_find(forest.parent, (uint32_t)r);
+        if (root == r) map->components.component_count++;
+        if (root == start_root)
+            map->components.start_component_cells += (uint64_t)(forest.runs[r].x1 - forest.runs[r].x0 + 1);
+    }
+
+    // A survivor counts if the robot can stand within detection range of it
+    for (int s = 0; s < map->survivor_count; s++) {
+        Position pos = map->survivors[s].pos;
+        reachable[s] = 0;
+
+        for (int dz = -DETECTION_RADIUS; dz <= DETECTION_RADIUS && !reachable[s]; dz++)
+            for (int dy = -DETECTION_RADIUS; dy <= DETECTION_RADIUS && !reachable[s]; dy++)
+                for (int dx = -DETECTION_RADIUS; dx <= DETECTION_RADIUS && !reachable[s]; dx++) {
+                    Position p = {pos.x + dx, pos.y + dy, pos.z + dz};
+                    if (!is_valid_position(map, p)) continue;
+
+                    long run = find_run(map, &forest, p.x, p.y, p.z);
+                    if (run >= 0 && run_find(forest.parent, (uint32_t)run) == start_root)
+                        reachable[s] = 1;
+                }
+
+        map->components.reachable_survivors += reachable[s];
+    }
+
+    free_run_forest(&forest);
+    map->survivor_reachable = reachable;
+    return true;
+}
+
+float map_fitness_upper_bound(const Map3D *map, float w_survivors, float w_coverage, int max_moves)
+{
+    // Length and risk only subtract; a path of max_moves visits at most
+    // max_moves + 1 cells, all inside the start component
+    uint64_t coverage = (uint64_t)max_moves + 1;
+    if (coverage > map->components.start_component_cells)
+        coverage = map->components.start_component_cells;
+
+    return w_survivors * map->components.reachable_survivors + w_coverage * (float)coverage;
+}
+
+void print_map_reachability(const Map3D *map)
+{
+    if (!map || !map->survivor_reachable) return;
+
+    int walled_in = map->survivor_count - map->components.reachable_survivors;
+    printf("\n🧭 Reachability:\n");
+    printf("  Free-space components:  %llu\n", (unsigned long long)map->components.component_count);
+    printf("  Start component:        %llu cells\n",
+           (unsigned long long)map->components.start_component_cells);
+    printf("  Reachable survivors:    %d / %d", map->components.reachable_survivors, map->survivor_count);
+    if (walled_in > 0) printf("  (⚠️  %d walled in, ignored by evaluation)", walled_in);
+    printf("\n");
+    printf("  Fitness upper bound:    %d survivors + min(moves + 1, %llu) cells coverage\n",
+           map->components.reachable_survivors,
+           (unsigned long long)map->components.start_component_cells);
+}
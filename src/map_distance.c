@@ -0,0 +1,272 @@
+#include "map_distance.h"
+#include "map_components.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// BFS DISTANCE FIELDS
+// ============================================================
+// Step counts over the 6-connected grid, where only rubble blocks a move
+// (survivor cells can be reached). Each field is a plain BFS from one or
+// more sources with a growable ring-buffer frontier. Fields do not depend
+// on each other, so the start, exit, nearest-survivor and per-group fields
+// are filled in parallel.
+
+// Frontier entries are plain cell indices: the border is set in the
+// obstacle bitmap, so neighbours come from map_step() with no bounds
+// checks.
+
+typedef struct {
+    uint64_t *items;
+    size_t mask;                 // capacity - 1 (power of two)
+    size_t head, tail;           // free-running; index with & mask
+} BfsRing;
+
+static bool ring_init(BfsRing *ring, size_t capacity)
+{
+    size_t size = 1024;
+    while (size < capacity) size <<= 1;
+
+    ring->items = (uint64_t *)malloc(size * sizeof(uint64_t));
+    ring->mask = size - 1;
+    ring->head = ring->tail = 0;
+    return ring->items != NULL;
+}
+
+static bool ring_push(BfsRing *ring, uint64_t item)
+{
+    if (ring->tail - ring->head > ring->mask) {
+        // Full: unwrap into a buffer twice as large
+        size_t count = ring->tail - ring->head;
+        uint64_t *grown = (uint64_t *)malloc(2 * count * sizeof(uint64_t));
+        if (!grown) return false;
+
+        for (size_t i = 0; i < count; i++)
+            grown[i] = ring->items[(ring->head + i) & ring->mask];
+        free(ring->items);
+        ring->items = grown;
+        ring->mask = 2 * count - 1;
+        ring->head = 0;
+        ring->tail = count;
+    }
+
+    ring->items[ring->tail++ & ring->mask] = item;
+    return true;
+}
+
+bool map_bfs_distance(const Map3D *map, const size_t *sources, size_t source_count, uint16_t *out)
+{
+    if (!map || !out) return false;
+
+    memset(out, 0xFF, map->cell_count * sizeof(uint16_t));
+
+    // The frontier of a grid BFS rarely exceeds a few cross-sections
+    size_t row = (size_t)map->width;
+    size_t floor_size = row * map->height;
+    size_t faces = floor_size + row * map->depth + (size_t)map->height * map->depth;
+    BfsRing ring;
+    if (!ring_init(&ring, 2 * faces > source_count ? 2 * faces : source_count))
+        return false;
+
+    bool ok = true;
+
+    for (size_t s = 0; ok && s < source_count; s++) {
+        if (sources[s] >= map->cell_count || out[sources[s]] == 0 ||
+            map_cell_at(map, sources[s]) == CELL_BORDER)
+            continue;
+        out[sources[s]] = 0;
+        ok = ring_push(&ring, sources[s]);
+    }
+
+    // Rubble and border block, each cell is settled once
+    while (ok && ring.head != ring.tail) {
+        size_t idx = (size_t)ring.items[ring.head++ & ring.mask];
+        uint16_t next = out[idx] < DIST_MAX ? (uint16_t)(out[idx] + 1) : DIST_MAX;
+
+        for (int m = 0; ok && m < 6; m++) {
+            size_t n = map_step(map, idx, m);
+            if (out[n] == DIST_UNREACHABLE && !map_is_obstacle_at(map, n)) {
+                out[n] = next;
+                ok = ring_push(&ring, n);
+            }
+        }
+    }
+
+    free(ring.items);
+    return ok;
+}
+
+// ============================================================
+// SURVIVOR GROUPS
+// ============================================================
+// One field per survivor while they fit the budget; otherwise survivors
+// are bucketed into cubic tiles, doubling the tile side until at most
+// max_groups tiles are occupied. Survivors that cannot be detected from
+// the start component get no group (-1).
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t tile_key(const Map3D *map, Position pos, int shift)
+{
+    uint64_t tiles_x = ((uint64_t)map->width >> shift) + 1;
+    uint64_t tiles_y = ((uint64_t)map->height >> shift) + 1;
+    return (((uint64_t)(pos.z >> shift) * tiles_y) + (uint64_t)(pos.y >> shift)) * tiles_x +
+           (uint64_t)(pos.x >> shift);
+}
+
+static size_t unique_keys(uint64_t *keys, size_t count)
+{
+    qsort(keys, count, sizeof(uint64_t), compare_u64);
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++)
+        if (i == 0 || keys[i] != keys[unique - 1]) keys[unique++] = keys[i];
+    return unique;
+}
+
+static int assign_survivor_groups(const Map3D *map, int max_groups, int32_t *group)
+{
+    int n = 0;
+    for (int s = 0; s < map->survivor_count; s++) {
+        group[s] = map_survivor_reachable(map, s) ? n++ : -1;
+    }
+    if (n <= max_groups) return n;
+
+    uint64_t *keys = (uint64_t *)malloc((size_t)n * sizeof(uint64_t));
+    if (!keys) return -1;
+
+    int shift = 1;
+    size_t unique;
+    for (;; shift++) {
+        for (int s = 0, k = 0; s < map->survivor_count; s++)
+            if (group[s] >= 0) keys[k++] = tile_key(map, map->survivors[s].pos, shift);
+        unique = unique_keys(keys, (size_t)n);
+        if (unique <= (size_t)max_groups) break;
+    }
+
+    // Group id = rank of the tile among the occupied ones
+    for (int s = 0; s < map->survivor_count; s++) {
+        if (group[s] < 0) continue;
+        uint64_t key = tile_key(map, map->survivors[s].pos, shift);
+        uint64_t *hit = (uint64_t *)bsearch(&key, keys, unique, sizeof(uint64_t), compare_u64);
+        group[s] = (int32_t)(hit - keys);
+    }
+
+    free(keys);
+    return (int)unique;
+}
+
+// ============================================================
+// BUILD ALL FIELDS
+// ============================================================
+static void release_distance_fields(Map3D *map)
+{
+    map_release_buffer(map, map->dist_start);
+    map_release_buffer(map, map->dist_exit);
+    map_release_buffer(map, map->dist_survivors);
+    map_release_buffer(map, map->dist_groups);
+    map_release_buffer(map, map->survivor_group);
+    map->dist_start = map->dist_exit = map->dist_survivors = map->dist_groups = NULL;
+    map->survivor_group = NULL;
+    map->dist_group_count = 0;
+}
+
+bool map_build_distance_fields(Map3D *map)
+{
+    if (!map) return false;
+
+    release_distance_fields(map);
+
+    size_t field_bytes = map->cell_count * sizeof(uint16_t);
+    size_t budget_groups = field_bytes ? DIST_GROUP_BUDGET / field_bytes : 0;
+    int max_groups = budget_groups < DIST_MAX_GROUPS ? (int)budget_groups : DIST_MAX_GROUPS;
+
+    int survivors = map->survivor_count;
+    map->dist_start = (uint16_t *)malloc(field_bytes);
+    map->dist_exit = (uint16_t *)malloc(field_bytes);
+    if (survivors > 0) {
+        map->dist_survivors = (uint16_t *)malloc(field_bytes);
+        map->survivor_group = (int32_t *)malloc((size_t)survivors * sizeof(int32_t));
+    }
+    size_t *sources = (size_t *)malloc(((size_t)survivors + 1) * sizeof(size_t));
+    size_t *group_first = (size_t *)calloc((size_t)max_groups + 2, sizeof(size_t));
+
+    bool ok = map->dist_start && map->dist_exit && sources && group_first &&
+              (survivors == 0 || (map->dist_survivors && map->survivor_group));
+
+    if (ok && survivors > 0 && max_groups > 0) {
+        int groups = assign_survivor_groups(map, max_groups, map->survivor_group);
+        ok = groups >= 0;
+        if (ok && groups > 0) {
+            map->dist_groups = (uint16_t *)malloc((size_t)groups * field_bytes);
+            ok = map->dist_groups != NULL;
+            map->dist_group_count = groups;
+        }
+    } else if (ok && survivors > 0) {
+        for (int s = 0; s < survivors; s++) map->survivor_group[s] = -1;
+    }
+
+    if (!ok) {
+        printf("❌ Memory allocation error for distance fields\n");
+        free(sources);
+        free(group_first);
+        release_distance_fields(map);
+        return false;
+    }
+
+    // Cells of detectable survivors ordered by group: group g owns
+    // sources[group_first[g] ..]
+    int groups = map->dist_group_count;
+    size_t targets = 0;
+    for (int s = 0; s < survivors; s++) {
+        if (!map_survivor_reachable(map, s)) continue;
+        if (groups > 0) group_first[map->survivor_group[s] + 1]++;
+        else sources[targets] = map_pos_index(map, map->survivors[s].pos);
+        targets++;
+    }
+    for (int g = 0; g < groups; g++)
+        group_first[g + 1] += group_first[g];
+    for (int s = 0; s < survivors && groups > 0; s++) {
+        if (map->survivor_group[s] >= 0)
+            sources[group_first[map->survivor_group[s]]++] = map_pos_index(map, map->survivors[s].pos);
+    }
+    for (int g = groups; g > 0; g--)
+        group_first[g] = group_first[g - 1];
+    group_first[0] = 0;
+
+    size_t start_cell = map_pos_index(map, map->start_position);
+    size_t exit_cell = map_pos_index(map, map->exit_position);
+    int jobs = 3 + groups;
+    int failed = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:failed)
+    for (int job = 0; job < jobs; job++) {
+        bool done = true;
+        if (job == 0)
+            done = map_bfs_distance(map, &start_cell, 1, map->dist_start);
+        else if (job == 1)
+            done = map_bfs_distance(map, &exit_cell, 1, map->dist_exit);
+        else if (job == 2 && survivors > 0)
+            done = map_bfs_distance(map, sources, targets, map->dist_survivors);
+        else if (job >= 3) {
+            int g = job - 3;
+            done = map_bfs_distance(map, sources + group_first[g], group_first[g + 1] - group_first[g],
+                                    map->dist_groups + (size_t)g * map->cell_count);
+        }
+        failed += !done;
+    }
+
+    free(sources);
+    free(group_first);
+
+    if (failed) {
+        printf("❌ Memory allocation error for BFS frontier\n");
+        release_distance_fields(map);
+        return false;
+    }
+    return true;
+}
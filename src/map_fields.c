@@ -0,0 +1,230 @@
+#include "map_fields.h"
+#include "map_components.h"
+#include "map_volume.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================
+// RISK FIELD
+// ============================================================
+// Risk of a cell = sum over obstacles in the 5x5x5 window around it of
+// 1 / (distance + 1). Distances only take a handful of values, so the
+// window is binned: each floor first counts its obstacles per in-plane
+// distance class, then the 5 floors of the window are combined with a
+// small weight table. Both passes run in parallel across floors.
+
+#define RISK_PLANAR_BINS 6      // dx^2 + dy^2 in {0, 1, 2, 4, 5, 8}
+
+static const int planar_bin_of_r2[9] = {0, 1, 2, -1, 3, 4, -1, -1, 5};
+static const int planar_bin_r2[RISK_PLANAR_BINS] = {0, 1, 2, 4, 5, 8};
+
+static inline float risk_weight(int r2)
+{
+    return 1.0f / (sqrtf((float)r2) + 1.0f);
+}
+
+float map_compute_cell_risk(const Map3D *map, size_t idx)
+{
+    Position pos = map_index_to_position(map, idx);
+    float risk = 0.0f;
+
+    // Rubble-free windows need no scan
+    if (map->rubble_sums &&
+        map_count_rubble_box(map, pos.x - RISK_RADIUS, pos.y - RISK_RADIUS, pos.z - RISK_RADIUS,
+                             pos.x + RISK_RADIUS, pos.y + RISK_RADIUS, pos.z + RISK_RADIUS) == 0)
+        return 0.0f;
+
+    for (int dz = -RISK_RADIUS; dz <= RISK_RADIUS; dz++) {
+        int z = pos.z + dz;
+        if (z < 0 || z >= map->depth) continue;
+
+        for (int dy = -RISK_RADIUS; dy <= RISK_RADIUS; dy++) {
+            int y = pos.y + dy;
+            if (y < 0 || y >= map->height) continue;
+
+            for (int dx = -RISK_RADIUS; dx <= RISK_RADIUS; dx++) {
+                int x = pos.x + dx;
+                if (x < 0 || x >= map->width) continue;
+
+                if (map_cell_at(map, map_index(map, x, y, z)) == CELL_OBSTACLE) {
+                    risk += risk_weight(dx * dx + dy * dy + dz * dz);
+                }
+            }
+        }
+    }
+
+    return risk;
+}
+
+bool map_build_risk_field(Map3D *map)
+{
+    if (!map) return false;
+
+    map_release_buffer(map, map->risk_field);
+    map->risk_field = (float *)aligned_alloc(MAP_CACHE_LINE,
+        ((map->cell_count * sizeof(float)) + MAP_CACHE_LINE - 1) & ~(size_t)(MAP_CACHE_LINE - 1));
+    uint8_t (*bins)[RISK_PLANAR_BINS] = malloc(map->cell_count * sizeof(*bins));
+
+    if (!map->risk_field || !bins) {
+        printf("❌ Memory allocation error for risk field\n");
+        free(map->risk_field);
+        free(bins);
+        map->risk_field = NULL;
+        return false;
+    }
+
+    // Border entries stay zero
+    memset(map->risk_field, 0, map->cell_count * sizeof(float));
+
+    // weight[b][|dz|] for planar bin b at floor offset dz
+    float weight[RISK_PLANAR_BINS][RISK_RADIUS + 1];
+    for (int b = 0; b < RISK_PLANAR_BINS; b++)
+        for (int dz = 0; dz <= RISK_RADIUS; dz++)
+            weight[b][dz] = risk_weight(planar_bin_r2[b] + dz * dz);
+
+    const int width = map->width;
+    const int height = map->height;
+    const int depth = map->depth;
+
+    // Pass 1: per-floor obstacle counts by in-plane distance class
+    #pragma omp parallel for schedule(static)
+    for (int z = 0; z < depth; z++) {
+        for (int y = 0; y < height; y++) {
+            int y0 = y - RISK_RADIUS < 0 ? 0 : y - RISK_RADIUS;
+            int y1 = y + RISK_RADIUS >= height ? height - 1 : y + RISK_RADIUS;
+
+            for (int x = 0; x < width; x++) {
+                int x0 = x - RISK_RADIUS < 0 ? 0 : x - RISK_RADIUS;
+                int x1 = x + RISK_RADIUS >= width ? width - 1 : x + RISK_RADIUS;
+                uint8_t *count = bins[map_index(map, x, y, z)];
+                memset(count, 0, RISK_PLANAR_BINS);
+
+                for (int ny = y0; ny <= y1; ny++) {
+                    size_t n = map_index(map, x0, ny, z);
+                    int dy2 = (ny - y) * (ny - y);
+                    for (int nx = x0; nx <= x1; nx++, n = map_step(map, n, MAP_MOVE_NEXT_X)) {
+                        if (map->cells[n] == CELL_OBSTACLE)
+                            count[planar_bin_of_r2[(nx - x) * (nx - x) + dy2]]++;
+                    }
+                }
+            }
+        }
+    }
+
+    // Pass 2: combine the floors of the window
+    #pragma omp parallel for schedule(static)
+    for (int z = 0; z < depth; z++) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                float risk = 0.0f;
+                for (int dz = -RISK_RADIUS; dz <= RISK_RADIUS; dz++) {
+                    if (z + dz < 0 || z + dz >= depth) continue;
+
+                    const uint8_t *count = bins[map_index(map, x, y, z + dz)];
+                    const int adz = dz < 0 ? -dz : dz;
+                    for (int b = 0; b < RISK_PLANAR_BINS; b++)
+                        risk += count[b] * weight[b][adz];
+                }
+                map->risk_field[map_index(map, x, y, z)] = risk;
+            }
+        }
+    }
+
+    free(bins);
+    return true;
+}
+
+// ============================================================
+// SURVIVOR DETECTION LISTS (CSR)
+// ============================================================
+// Row i lists the survivors a robot standing in cell i detects. Rows
+// exist for every cell, rubble included, because decoded paths are
+// only clamped to the map bounds and may pass through obstacles.
+// Survivors that cannot be detected from the start component are left
+// out, so no path is rewarded for them.
+
+static int detection_neighbors(const Map3D *map, Position center, size_t *out)
+{
+    int n = 0;
+    for (int dz = -DETECTION_RADIUS; dz <= DETECTION_RADIUS; dz++) {
+        for (int dy = -DETECTION_RADIUS; dy <= DETECTION_RADIUS; dy++) {
+            for (int dx = -DETECTION_RADIUS; dx <= DETECTION_RADIUS; dx++) {
+                Position p = {center.x + dx, center.y + dy, center.z + dz};
+                if (is_valid_position(map, p))
+                    out[n++] = map_pos_index(map, p);
+            }
+        }
+    }
+    return n;
+}
+
+bool map_build_detection_lists(Map3D *map)
+{
+    if (!map) return false;
+
+    map_release_buffer(map, map->detect_offsets);
+    map_release_buffer(map, map->detect_ids);
+    map->detect_ids = NULL;
+
+    map->detect_offsets = (uint32_t *)calloc(map->cell_count + 1, sizeof(uint32_t));
+    if (!map->detect_offsets) {
+        printf("❌ Memory allocation error for detection lists\n");
+        return false;
+    }
+
+    size_t cells[(2 * DETECTION_RADIUS + 1) * (2 * DETECTION_RADIUS + 1) * (2 * DETECTION_RADIUS + 1)];
+
+    // Count entries per row
+    for (int s = 0; s < map->survivor_count; s++) {
+        if (!map_survivor_reachable(map, s)) continue;
+        int n = detection_neighbors(map, map->survivors[s].pos, cells);
+        for (int k = 0; k < n; k++)
+            map->detect_offsets[cells[k] + 1]++;
+    }
+
+    for (size_t i = 0; i < map->cell_count; i++)
+        map->detect_offsets[i + 1] += map->detect_offsets[i];
+
+    uint32_t total = map->detect_offsets[map->cell_count];
+    map->detect_ids = (int32_t *)malloc((total ? total : 1) * sizeof(int32_t));
+    uint32_t *cursor = (uint32_t *)malloc(map->cell_count * sizeof(uint32_t));
+    if (!map->detect_ids || !cursor) {
+        printf("❌ Memory allocation error for detection lists\n");
+        free(cursor);
+        free(map->detect_ids);
+        free(map->detect_offsets);
+        map->detect_ids = NULL;
+        map->detect_offsets = NULL;
+        return false;
+    }
+    memcpy(cursor, map->detect_offsets, map->cell_count * sizeof(uint32_t));
+
+    // Fill rows; ids end up sorted within each row
+    for (int s = 0; s < map->survivor_count; s++) {
+        if (!map_survivor_reachable(map, s)) continue;
+        int n = detection_neighbors(map, map->survivors[s].pos, cells);
+        for (int k = 0; k < n; k++)
+            map->detect_ids[cursor[cells[k]]++] = s;
+    }
+
+    free(cursor);
+    return true;
+}
+
+const int32_t *map_scan_detectable_survivors(const Map3D *map, size_t idx, int *count)
+{
+    static _Thread_local int32_t ids[(2 * DETECTION_RADIUS + 1) * (2 * DETECTION_RADIUS + 1) * (2 * DETECTION_RADIUS + 1)];
+    size_t cells[(2 * DETECTION_RADIUS + 1) * (2 * DETECTION_RADIUS + 1) * (2 * DETECTION_RADIUS + 1)];
+
+    int n = detection_neighbors(map, map_index_to_position(map, idx), cells);
+    int found = 0;
+    for (int k = 0; k < n; k++) {
+        int id = map_survivor_id_at(map, cells[k]);
+        if (id >= 0 && map_survivor_reachable(map, id)) ids[found++] = id;
+    }
+
+    *count = found;
+    return ids;
+}
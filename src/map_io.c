@@ -0,0 +1,724 @@
+#include "map_io.h"
+#include "map_fields.h"
+#include "map_bricks.h"
+#include "map_distance.h"
+#include "map_components.h"
+#include "map_volume.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SNAPSHOT_ALIGN MAP_CACHE_LINE
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+static uint64_t snapshot_align(uint64_t value)
+{
+    return (value + SNAPSHOT_ALIGN - 1) & ~(uint64_t)(SNAPSHOT_ALIGN - 1);
+}
+
+// ============================================================
+// SAVE BINARY SNAPSHOT
+// ============================================================
+bool save_map_snapshot(const Map3D *map, const char *filename)
+{
+    if (!map || !filename)
+        return false;
+
+    if (map->bricks) {
+        printf("⚠️  Binary snapshots hold dense maps only; use the text format for sparse maps\n");
+        return false;
+    }
+
+    size_t bitmap_bytes = (map->bitmap_words + 1) * sizeof(uint64_t);
+    struct {
+        uint32_t id;
+        const void *data;
+        uint64_t size;
+    } parts[] = {
+        {SNAP_SECTION_CELLS, map->cells, map->cell_count},
+        {SNAP_SECTION_OBSTACLE_BITS, map->obstacle_bits, bitmap_bytes},
+        {SNAP_SECTION_SURVIVOR_BITS, map->survivor_bits, bitmap_bytes},
+        {SNAP_SECTION_SURVIVORS, map->survivors, (uint64_t)map->survivor_count * sizeof(Survivor)},
+        {SNAP_SECTION_SURVIVOR_IDS, map->survivor_ids, map->cell_count * sizeof(int32_t)},
+        {SNAP_SECTION_SURVIVOR_TABLE, map->survivor_table,
+         map->survivor_table ? (map->survivor_table_mask + 1) * sizeof(SurvivorSlot) : 0},
+        {SNAP_SECTION_RISK_FIELD, map->risk_field, map->cell_count * sizeof(float)},
+        {SNAP_SECTION_DETECT_OFFSETS, map->detect_offsets, (map->cell_count + 1) * sizeof(uint32_t)},
+        {SNAP_SECTION_DETECT_IDS, map->detect_ids,
+         map->detect_offsets ? map->detect_offsets[map->cell_count] * sizeof(int32_t) : 0},
+        {SNAP_SECTION_DIST_START, map->dist_start, map->cell_count * sizeof(uint16_t)},
+        {SNAP_SECTION_DIST_EXIT, map->dist_exit, map->cell_count * sizeof(uint16_t)},
+        {SNAP_SECTION_DIST_SURVIVORS, map->dist_survivors, map->cell_count * sizeof(uint16_t)},
+        {SNAP_SECTION_DIST_GROUPS, map->dist_groups,
+         (uint64_t)map->dist_group_count * map->cell_count * sizeof(uint16_t)},
+        {SNAP_SECTION_SURVIVOR_GROUPS, map->survivor_group,
+         map->survivor_group ? (uint64_t)map->survivor_count * sizeof(int32_t) : 0},
+        {SNAP_SECTION_SURVIVOR_REACHABLE, map->survivor_reachable,
+         map->survivor_reachable ? (uint64_t)map->survivor_count : 0},
+        {SNAP_SECTION_COMPONENT_STATS, &map->components,
+         map->survivor_reachable ? sizeof(MapComponentStats) : 0},
+        {SNAP_SECTION_RUBBLE_SUMS, map->rubble_sums, map_rubble_sums_length(map) * sizeof(uint32_t)},
+    };
+    int part_count = (int)(sizeof(parts) / sizeof(parts[0]));
+
+    MapSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAP_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = MAP_SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.header_size = sizeof(MapSnapshotHeader);
+    header.survivor_record_size = sizeof(Survivor);
+    header.width = map->width;
+    header.height = map->height;
+    header.depth = map->depth;
+    header.survivor_count = map->survivor_count;
+    header.start_position = map->start_position;
+    header.exit_position = map->exit_position;
+    header.cell_count = map->cell_count;
+    header.layout = (uint32_t)map->layout;
+    header.bitmap_words = map->bitmap_words;
+    header.survivor_table_mask = map->survivor_table_mask;
+
+    // Lay out the sections that are present, each on its own cache line
+    uint64_t offset = snapshot_align(sizeof(MapSnapshotHeader));
+    for (int i = 0; i < part_count; i++)
+    {
+        if (!parts[i].data || parts[i].size == 0)
+            continue;
+
+        SnapshotSection *section = &header.sections[header.section_count++];
+        section->id = parts[i].id;
+        section->offset = offset;
+        section->size = parts[i].size;
+        offset = snapshot_align(offset + parts[i].size);
+    }
+
+    // Written beside the target and renamed over it: a map loaded from this
+    // file keeps reading the old inode instead of a truncated mapping
+    size_t name_length = strlen(filename);
+    char *temp_name = (char *)malloc(name_length + sizeof(".tmp"));
+    if (!temp_name)
+    {
+        printf("❌ Memory allocation error for snapshot file name\n");
+        return false;
+    }
+    memcpy(temp_name, filename, name_length);
+    memcpy(temp_name + name_length, ".tmp", sizeof(".tmp"));
+
+    FILE *file = fopen(temp_name, "wb");
+    if (!file)
+    {
+        printf("Error: Cannot create file '%s'\n", temp_name);
+        free(temp_name);
+        return false;
+    }
+
+    static const uint8_t padding[SNAPSHOT_ALIGN] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    uint64_t written = sizeof(header);
+
+    for (uint32_t s = 0; ok && s < header.section_count; s++)
+    {
+        const SnapshotSection *section = &header.sections[s];
+        const void *data = NULL;
+        for (int i = 0; i < part_count; i++)
+            if (parts[i].id == section->id) data = parts[i].data;
+
+        ok = fwrite(padding, 1, section->offset - written, file) == section->offset - written &&
+             fwrite(data, 1, section->size, file) == section->size;
+        written = section->offset + section->size;
+    }
+
+    // Pad the tail so the file length is a whole number of cache lines
+    if (ok && snapshot_align(written) > written)
+        ok = fwrite(padding, 1, snapshot_align(written) - written, file) == snapshot_align(written) - written;
+
+    if (fclose(file) != 0)
+        ok = false;
+    if (ok && rename(temp_name, filename) != 0)
+        ok = false;
+
+    if (!ok)
+    {
+        printf("❌ Error writing map snapshot '%s'\n", filename);
+        remove(temp_name);
+        free(temp_name);
+        return false;
+    }
+    free(temp_name);
+
+    printf("✅ Map snapshot saved to: '%s' (%llu bytes, %u sections)\n",
+           filename, (unsigned long long)snapshot_align(written), header.section_count);
+    return true;
+}
+
+// ============================================================
+// LOAD BINARY SNAPSHOT (read-only mapping, no parsing)
+// ============================================================
+static bool snapshot_section_fits(const SnapshotSection *section, uint64_t file_size)
+{
+    return section->offset % SNAPSHOT_ALIGN == 0 &&
+           section->offset <= file_size &&
+           section->size <= file_size - section->offset;
+}
+
+// Everything later code uses as an index is checked once here: a snapshot
+// that passes the size checks but carries a stray offset, id or border cell
+// would otherwise be read out of bounds during evaluation.
+static bool snapshot_contents_valid(const Map3D *map)
+{
+    if (!is_valid_position(map, map->start_position) || !is_valid_position(map, map->exit_position))
+        return false;
+
+    for (int i = 0; i < map->survivor_count; i++)
+        if (!is_valid_position(map, map->survivors[i].pos))
+            return false;
+
+    // Walkers stop on CELL_BORDER, so the padding must still be intact
+    int pw = map->width + 2 * MAP_PAD, ph = map->height + 2 * MAP_PAD, pd = map->depth + 2 * MAP_PAD;
+    for (int z = 0; z < pd; z++)
+        for (int y = 0; y < ph; y++)
+            for (int x = 0; x < pw; x++)
+            {
+                bool border = x < MAP_PAD || x >= pw - MAP_PAD ||
+                              y < MAP_PAD || y >= ph - MAP_PAD ||
+                              z < MAP_PAD || z >= pd - MAP_PAD;
+                uint8_t cell = map->cells[map_index(map, x - MAP_PAD, y - MAP_PAD, z - MAP_PAD)];
+                if (border ? cell != CELL_BORDER : cell >= CELL_BORDER)
+                    return false;
+            }
+
+    if (map->survivor_ids)
+    {
+        for (size_t i = 0; i < map->cell_count; i++)
+            if (map->survivor_ids[i] < -1 || map->survivor_ids[i] >= map->survivor_count)
+                return false;
+    }
+
+    if (map->survivor_table)
+    {
+        // Lookups probe until an empty slot, so at least one must exist
+        size_t capacity = map->survivor_table_mask + 1;
+        size_t empty = 0;
+        if (capacity & map->survivor_table_mask)
+            return false;
+        for (size_t i = 0; i < capacity; i++)
+        {
+            const SurvivorSlot *slot = &map->survivor_table[i];
+            if (slot->cell == SURVIVOR_SLOT_EMPTY)
+                empty++;
+            else if (slot->cell >= map->cell_count || slot->id < 0 || slot->id >= map->survivor_count)
+                return false;
+        }
+        if (empty == 0)
+            return false;
+    }
+
+    if (map->detect_offsets && map->detect_ids)
+    {
+        if (map->detect_offsets[0] != 0)
+            return false;
+        for (size_t i = 0; i < map->cell_count; i++)
+            if (map->detect_offsets[i + 1] < map->detect_offsets[i])
+                return false;
+        for (uint32_t k = 0; k < map->detect_offsets[map->cell_count]; k++)
+            if (map->detect_ids[k] < 0 || map->detect_ids[k] >= map->survivor_count)
+                return false;
+    }
+
+    return true;
+}
+
+Map3D *load_map_mmap(const char *filename)
+{
+    if (!filename)
+        return NULL;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("ERROR: Map snapshot '%s' not found.\n", filename);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(MapSnapshotHeader))
+    {
+        printf("ERROR: '%s' is not a map snapshot.\n", filename);
+        close(fd);
+        return NULL;
+    }
+
+    // MAP_SHARED: every process that maps the file shares the page cache copy
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        printf("ERROR: Cannot map snapshot '%s' into memory.\n", filename);
+        return NULL;
+    }
+
+    const MapSnapshotHeader *header = (const MapSnapshotHeader *)base;
+    uint64_t file_size = (uint64_t)st.st_size;
+
+    if (memcmp(header->magic, MAP_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != MAP_SNAPSHOT_VERSION ||
+        header->byte_order != SNAPSHOT_BYTE_ORDER ||
+        header->header_size != sizeof(MapSnapshotHeader) ||
+        header->survivor_record_size != sizeof(Survivor) ||
+        header->width <= 0 || header->height <= 0 || header->depth <= 0 ||
+        header->survivor_count < 0 ||
+        header->layout > MAP_LAYOUT_MORTON ||
+        header->bitmap_words != (header->cell_count + 63) / 64 ||
+        header->section_count > MAP_SNAPSHOT_MAX_SECTIONS)
+    {
+        printf("ERROR: '%s' is not a compatible map snapshot.\n", filename);
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    Map3D *map = (Map3D *)calloc(1, sizeof(Map3D));
+    if (!map)
+    {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    map_set_geometry(map, header->width, header->height, header->depth, (MapLayout)header->layout);
+    if (map->cell_count != header->cell_count)
+    {
+        printf("ERROR: '%s' is not a compatible map snapshot.\n", filename);
+        free(map);
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+    map->bitmap_words = header->bitmap_words;
+    map->survivor_count = header->survivor_count;
+    map->start_position = header->start_position;
+    map->exit_position = header->exit_position;
+    map->mapped_base = base;
+    map->mapped_size = (size_t)st.st_size;
+
+    size_t bitmap_bytes = (map->bitmap_words + 1) * sizeof(uint64_t);
+    bool ok = true;
+
+    for (uint32_t s = 0; ok && s < header->section_count; s++)
+    {
+        const SnapshotSection *section = &header->sections[s];
+        void *data = (char *)base + section->offset;
+
+        if (!snapshot_section_fits(section, file_size))
+        {
+            ok = false;
+            break;
+        }
+
+        switch (section->id)
+        {
+        case SNAP_SECTION_CELLS:
+            ok = section->size == map->cell_count;
+            map->cells = (uint8_t *)data;
+            break;
+        case SNAP_SECTION_OBSTACLE_BITS:
+            ok = section->size == bitmap_bytes;
+            map->obstacle_bits = (uint64_t *)data;
+            break;
+        case SNAP_SECTION_SURVIVOR_BITS:
+            ok = section->size == bitmap_bytes;
+            map->survivor_bits = (uint64_t *)data;
+            break;
+        case SNAP_SECTION_SURVIVORS:
+            ok = section->size == (uint64_t)map->survivor_count * sizeof(Survivor);
+            map->survivors = (Survivor *)data;
+            break;
+        case SNAP_SECTION_SURVIVOR_IDS:
+            ok = section->size == map->cell_count * sizeof(int32_t);
+            map->survivor_ids = (int32_t *)data;
+            break;
+        case SNAP_SECTION_SURVIVOR_TABLE:
+            ok = section->size == (header->survivor_table_mask + 1) * sizeof(SurvivorSlot);
+            map->survivor_table = (SurvivorSlot *)data;
+            map->survivor_table_mask = header->survivor_table_mask;
+            break;
+        case SNAP_SECTION_RISK_FIELD:
+            ok = section->size == map->cell_count * sizeof(float);
+            map->risk_field = (float *)data;
+            break;
+        case SNAP_SECTION_DETECT_OFFSETS:
+            ok = section->size == (map->cell_count + 1) * sizeof(uint32_t);
+            map->detect_offsets = (uint32_t *)data;
+            break;
+        case SNAP_SECTION_DETECT_IDS:
+            map->detect_ids = (int32_t *)data;
+            break;
+        case SNAP_SECTION_DIST_START:
+            ok = section->size == map->cell_count * sizeof(uint16_t);
+            map->dist_start = (uint16_t *)data;
+            break;
+        case SNAP_SECTION_DIST_EXIT:
+            ok = section->size == map->cell_count * sizeof(uint16_t);
+            map->dist_exit = (uint16_t *)data;
+            break;
+        case SNAP_SECTION_DIST_SURVIVORS:
+            ok = section->size == map->cell_count * sizeof(uint16_t);
+            map->dist_survivors = (uint16_t *)data;
+            break;
+        case SNAP_SECTION_DIST_GROUPS:
+            // One field per survivor group
+            ok = section->size % (map->cell_count * sizeof(uint16_t)) == 0 &&
+                 section->size / (map->cell_count * sizeof(uint16_t)) <= DIST_MAX_GROUPS;
+            map->dist_groups = (uint16_t *)data;
+            map->dist_group_count = (int)(section->size / (map->cell_count * sizeof(uint16_t)));
+            break;
+        case SNAP_SECTION_SURVIVOR_GROUPS:
+            ok = section->size == (uint64_t)map->survivor_count * sizeof(int32_t);
+            map->survivor_group = (int32_t *)data;
+            break;
+        case SNAP_SECTION_SURVIVOR_REACHABLE:
+            ok = section->size == (uint64_t)map->survivor_count;
+            map->survivor_reachable = (uint8_t *)data;
+            break;
+        case SNAP_SECTION_RUBBLE_SUMS:
+            ok = section->size == map_rubble_sums_length(map) * sizeof(uint32_t);
+            map->rubble_sums = (uint32_t *)data;
+            break;
+        case SNAP_SECTION_COMPONENT_STATS:
+            ok = section->size == sizeof(MapComponentStats);
+            memcpy(&map->components, data, sizeof(MapComponentStats));
+            break;
+        default:
+            // Unknown optional section from a newer writer
+            break;
+        }
+    }
+
+    if (ok && map->detect_offsets && map->detect_ids)
+    {
+        for (uint32_t s = 0; s < header->section_count; s++)
+            if (header->sections[s].id == SNAP_SECTION_DETECT_IDS)
+                ok = header->sections[s].size ==
+                     (uint64_t)map->detect_offsets[map->cell_count] * sizeof(int32_t);
+    }
+
+    for (int i = 0; ok && map->survivor_group && i < map->survivor_count; i++)
+        ok = map->survivor_group[i] >= -1 && map->survivor_group[i] < map->dist_group_count;
+
+    if (!ok || !map->cells || !map->obstacle_bits || !map->survivor_bits ||
+        (map->survivor_count > 0 && !map->survivors) ||
+        !snapshot_contents_valid(map))
+    {
+        printf("ERROR: Map snapshot '%s' is truncated or corrupted.\n", filename);
+        free(map);
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    // Optional precomputed data missing from the file is rebuilt on the heap.
+    // Detection lists and survivor groups depend on reachability, so a file
+    // written without it gets those rebuilt too.
+    if (!map->survivor_ids && !map->survivor_table)
+        map_build_survivor_index(map);
+    if (!map->survivor_reachable) {
+        map_label_components(map);
+        map->detect_offsets = NULL;
+        map->detect_ids = NULL;
+        map->dist_start = NULL;
+    }
+    if (!map->rubble_sums)
+        map_build_rubble_sums(map);
+    if (!map->risk_field)
+        map_build_risk_field(map);
+    if (!map->detect_offsets || !map->detect_ids)
+        map_build_detection_lists(map);
+    if (!map->dist_start || !map->dist_exit ||
+        (map->survivor_count > 0 && (!map->dist_survivors || !map->survivor_group)))
+        map_build_distance_fields(map);
+
+    printf("✅ Map snapshot mapped from '%s': %d × %d × %d, %d survivors\n",
+           filename, map->width, map->height, map->depth, map->survivor_count);
+    print_map_reachability(map);
+    return map;
+}
+
+// ============================================================
+// STREAMING TEXT LOADER
+// ============================================================
+// Reads the file in large blocks and parses fields by hand; sscanf
+// and per-line stdio calls dominate ingestion time on big scans.
+
+typedef struct {
+    Map3D *map;
+    int width, height, depth;
+    int survivor_hint;
+    int survivor_capacity;
+    int brick_layer;             // sparse maps: lowest brick layer not yet compacted
+    long long line_number;
+    long long bad_lines;
+} TextMapParser;
+
+static inline const char *skip_blanks(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+// Returns the position after the number, or NULL if there is none
+static inline const char *parse_int_field(const char *p, const char *end, int *out)
+{
+    p = skip_blanks(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    if (p >= end || (unsigned)(*p - '0') > 9) return NULL;
+
+    int value = 0;
+    while (p < end && (unsigned)(*p - '0') <= 9)
+        value = value * 10 + (*p++ - '0');
+
+    *out = negative ? -value : value;
+    return p;
+}
+
+static inline const char *parse_float_field(const char *p, const char *end, float *out)
+{
+    p = skip_blanks(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    const char *digits = p;
+    double value = 0.0;
+    while (p < end && (unsigned)(*p - '0') <= 9)
+        value = value * 10.0 + (*p++ - '0');
+
+    if (p < end && *p == '.') {
+        double scale = 0.1;
+        for (p++; p < end && (unsigned)(*p - '0') <= 9; p++, scale *= 0.1)
+            value += (*p - '0') * scale;
+    }
+    if (p == digits) return NULL;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        int exponent;
+        const char *after = parse_int_field(p + 1, end, &exponent);
+        if (after) {
+            p = after;
+            double base = exponent < 0 ? 0.1 : 10.0;
+            for (int e = exponent < 0 ? -exponent : exponent; e > 0; e--) value *= base;
+        }
+    }
+
+    *out = (float)(negative ? -value : value);
+    return p;
+}
+
+static inline const char *expect_comma(const char *p, const char *end)
+{
+    p = skip_blanks(p, end);
+    return (p < end && *p == ',') ? p + 1 : NULL;
+}
+
+static bool parse_header_value(const char *line, const char *end, const char *key, int *out)
+{
+    size_t key_len = strlen(key);
+    if ((size_t)(end - line) <= key_len || memcmp(line, key, key_len) != 0 || line[key_len] != '=')
+        return false;
+    return parse_int_field(line + key_len + 1, end, out) != NULL;
+}
+
+static bool text_parser_start_map(TextMapParser *parser)
+{
+    if (parser->width <= 0 || parser->height <= 0 || parser->depth <= 0) {
+        printf("ERROR: Map text is missing WIDTH/HEIGHT/DEPTH before cell data\n");
+        return false;
+    }
+
+    // Scans too large for a dense grid go to brick storage
+    size_t cells = (size_t)parser->width * parser->height * parser->depth;
+    parser->map = cells >= MAP_SPARSE_MIN_CELLS
+        ? create_sparse_map(parser->width, parser->height, parser->depth)
+        : create_map(parser->width, parser->height, parser->depth);
+    if (!parser->map) return false;
+
+    parser->survivor_capacity = parser->survivor_hint > 0 ? parser->survivor_hint : 64;
+    parser->map->survivors = (Survivor *)malloc(parser->survivor_capacity * sizeof(Survivor));
+    return parser->map->survivors != NULL;
+}
+
+static bool text_parser_add_survivor(TextMapParser *parser, const Survivor *survivor)
+{
+    Map3D *map = parser->map;
+
+    if (map->survivor_count == parser->survivor_capacity) {
+        int capacity = parser->survivor_capacity * 2;
+        Survivor *grown = (Survivor *)realloc(map->survivors, capacity * sizeof(Survivor));
+        if (!grown) return false;
+        map->survivors = grown;
+        parser->survivor_capacity = capacity;
+    }
+
+    map->survivors[map->survivor_count++] = *survivor;
+    return true;
+}
+
+// One line without its terminating newline
+static bool text_parser_line(TextMapParser *parser, const char *line, const char *end)
+{
+    parser->line_number++;
+    line = skip_blanks(line, end);
+    if (line >= end || *line == '#' || *line == '\r') return true;
+
+    // Header
+    if (*line >= 'A' && *line <= 'Z') {
+        if (!parse_header_value(line, end, "WIDTH", &parser->width) &&
+            !parse_header_value(line, end, "HEIGHT", &parser->height) &&
+            !parse_header_value(line, end, "DEPTH", &parser->depth))
+            parse_header_value(line, end, "SURVIVORS", &parser->survivor_hint);
+        return true;
+    }
+
+    if (!parser->map && !text_parser_start_map(parser))
+        return false;
+
+    // Cell: x,y,z,type[,priority,heat,co2,confidence,location]
+    Position pos;
+    int type;
+    const char *p = parse_int_field(line, end, &pos.x);
+    if (p) p = expect_comma(p, end);
+    if (p) p = parse_int_field(p, end, &pos.y);
+    if (p) p = expect_comma(p, end);
+    if (p) p = parse_int_field(p, end, &pos.z);
+    if (p) p = expect_comma(p, end);
+    if (p) p = parse_int_field(p, end, &type);
+
+    if (!p || !is_valid_position(parser->map, pos) || type < CELL_FREE || type > CELL_SURVIVOR) {
+        parser->bad_lines++;
+        return true;
+    }
+
+    Map3D *map = parser->map;
+
+    // Files are written floor by floor: once cells move past a layer of
+    // bricks, fold the uniform ones so peak memory stays low
+    if (map->bricks && (pos.z >> MAP_BRICK_SHIFT) > parser->brick_layer) {
+        int layer = pos.z >> MAP_BRICK_SHIFT;
+        map_compact_bricks(map, parser->brick_layer, layer - parser->brick_layer);
+        parser->brick_layer = layer;
+    }
+
+    if (type == CELL_OBSTACLE) {
+        map_set_cell_at(map, map_pos_index(map, pos), CELL_OBSTACLE);
+    } else if (type == CELL_SURVIVOR) {
+        Survivor survivor;
+        memset(&survivor, 0, sizeof(survivor));
+        survivor.pos = pos;
+        survivor.priority = 5;
+        survivor.heat_signal = 36.5f;
+        survivor.co2_level = 1500.0f;
+        survivor.sensor_confidence = 80;
+
+        // Optional sensor fields; missing ones keep the defaults above
+        const char *q = expect_comma(p, end);
+        if (q) q = parse_int_field(q, end, &survivor.priority);
+        if (q) q = expect_comma(q, end);
+        if (q) q = parse_float_field(q, end, &survivor.heat_signal);
+        if (q) q = expect_comma(q, end);
+        if (q) q = parse_float_field(q, end, &survivor.co2_level);
+        if (q) q = expect_comma(q, end);
+        if (q) parse_int_field(q, end, &survivor.sensor_confidence);
+
+        map_set_cell_at(map, map_pos_index(map, pos), CELL_SURVIVOR);
+        if (!text_parser_add_survivor(parser, &survivor)) return false;
+    }
+
+    return true;
+}
+
+// Cells and survivors only; load_map_from_text adds the derived data
+Map3D *load_map_cells_from_text(const char *filename)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        printf("ERROR: Map file '%s' not found.\n", filename);
+        return NULL;
+    }
+
+    char *buffer = (char *)malloc(MAP_TEXT_BLOCK_SIZE);
+    if (!buffer) {
+        fclose(file);
+        return NULL;
+    }
+
+    TextMapParser parser;
+    memset(&parser, 0, sizeof(parser));
+
+    size_t carried = 0;          // partial line kept from the previous block
+    bool ok = true;
+    bool eof = false;
+
+    while (ok && !eof) {
+        size_t got = fread(buffer + carried, 1, MAP_TEXT_BLOCK_SIZE - carried, file);
+        size_t filled = carried + got;
+        eof = got < MAP_TEXT_BLOCK_SIZE - carried;
+
+        const char *line = buffer;
+        const char *end = buffer + filled;
+        const char *newline;
+
+        while (ok && (newline = memchr(line, '\n', (size_t)(end - line))) != NULL) {
+            ok = text_parser_line(&parser, line, newline);
+            line = newline + 1;
+        }
+
+        carried = (size_t)(end - line);
+        if (ok && eof && carried > 0) {
+            ok = text_parser_line(&parser, line, end);
+            carried = 0;
+        } else if (ok && carried == MAP_TEXT_BLOCK_SIZE) {
+            printf("ERROR: Line %lld is longer than the read block\n", parser.line_number + 1);
+            ok = false;
+        }
+        memmove(buffer, line, carried);
+    }
+
+    if (ferror(file)) ok = false;
+    fclose(file);
+    free(buffer);
+
+    if (ok && !parser.map) ok = text_parser_start_map(&parser);
+
+    if (!ok) {
+        printf("❌ Failed to load map from '%s'\n", filename);
+        free_map(parser.map);
+        return NULL;
+    }
+
+    if (parser.bad_lines > 0)
+        printf("⚠️  Skipped %lld malformed cell lines\n", parser.bad_lines);
+
+    if (parser.map->bricks) {
+        const MapBricks *bricks = parser.map->bricks;
+        map_compact_bricks(parser.map, 0, bricks->bricks_z);
+        printf("🧊 Sparse storage: %zu of %zu bricks allocated, %.1f MB (dense grid: %.1f MB)\n",
+               bricks->allocated, bricks->brick_count,
+               map_storage_bytes(parser.map) / (1024.0 * 1024.0),
+               parser.map->cell_count / (1024.0 * 1024.0));
+    }
+    return parser.map;
+}
+
+Map3D *load_map_from_text(const char *filename)
+{
+    Map3D *map = load_map_cells_from_text(filename);
+    if (!map) return NULL;
+
+    map_build_derived_data(map);
+
+    printf("✅ Map loaded from '%s': %d × %d × %d, %d survivors\n",
+           filename, map->width, map->height, map->depth, map->survivor_count);
+    print_map_reachability(map);
+    return map;
+}
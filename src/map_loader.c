@@ -1,9 +1,16 @@
 #include "map_loader.h"
+#include "map_fields.h"
+#include "map_bricks.h"
+#include "map_distance.h"
+#include "map_components.h"
+#include "map_volume.h"
+#include "rng.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <sys/mman.h>
 
 // ============================================================
 // CONSTANTS - SINGLE DEFINITIONS
@@ -27,6 +34,11 @@
 #define MEDIUM_DENSITY_RATIO 0.35f
 #define LOW_DENSITY_RATIO 0.15f
 
+// SURVIVOR INDEX
+// Dense cell->id array once at least 1 in N cells holds a survivor,
+// otherwise an open-addressing hash sized for the survivors only
+#define SURVIVOR_DENSE_INDEX_RATIO 8
+
 // ============================================================
 // HELPER FUNCTIONS
 // ============================================================
@@ -51,31 +63,96 @@ bool is_in_central_area(const Map3D *map, Position pos) {
 // ============================================================
 // 1️⃣ CREATE MAP (بقى كما هو)
 // ============================================================
-Map3D *create_map(int width, int height, int depth)
+// Unit steps in Direction order; the last entry is "wait"
+const Position map_move_offsets[MAP_MOVE_COUNT] = {
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {0, 0, 0}
+};
+
+// New serial for a map whose contents changed; 0 marks data of no map
+void map_bump_serial(Map3D *map)
 {
-    Map3D *map = (Map3D *)malloc(sizeof(Map3D));
-    if (!map) return NULL;
+    static uint64_t next_serial = 0;
+    uint64_t serial;
+    #pragma omp atomic capture
+    serial = ++next_serial;
+    map->serial = serial;
+}
 
+// Index space of a map wrapped in a MAP_PAD-thick border: every interior
+// cell has its 6 neighbours inside the array, so walkers step with
+// map_step() and stop on the border instead of bounds-checking.
+// The Morton layout rounds the padded box up to whole 8x8x8 blocks; the
+// extra cells are border too. Its move_delta holds whole-block steps.
+void map_set_geometry(Map3D *map, int width, int height, int depth, MapLayout layout)
+{
     map->width = width;
     map->height = height;
     map->depth = depth;
+    map->layout = layout;
+    map_bump_serial(map);
+
+    map->stride_y = (size_t)width + 2 * MAP_PAD;
+    map->stride_z = map->stride_y * ((size_t)height + 2 * MAP_PAD);
+    map->volume = (size_t)width * height * depth;
+
+    const size_t block_side = (size_t)1 << MAP_MORTON_SHIFT;
+    map->blocks_x = (map->stride_y + block_side - 1) >> MAP_MORTON_SHIFT;
+    map->blocks_y = ((size_t)height + 2 * MAP_PAD + block_side - 1) >> MAP_MORTON_SHIFT;
+
+    ptrdiff_t step_x = 1, step_y = (ptrdiff_t)map->stride_y, step_z = (ptrdiff_t)map->stride_z;
+    if (layout == MAP_LAYOUT_MORTON) {
+        size_t blocks_z = ((size_t)depth + 2 * MAP_PAD + block_side - 1) >> MAP_MORTON_SHIFT;
+        map->cell_count = (map->blocks_x * map->blocks_y * blocks_z) << MAP_MORTON_BITS;
+        step_x = (ptrdiff_t)1 << MAP_MORTON_BITS;
+        step_y = (ptrdiff_t)map->blocks_x << MAP_MORTON_BITS;
+        step_z = (ptrdiff_t)(map->blocks_x * map->blocks_y) << MAP_MORTON_BITS;
+    } else {
+        map->cell_count = map->stride_z * ((size_t)depth + 2 * MAP_PAD);
+    }
 
-    map->grid = (int ***)malloc(depth * sizeof(int **));
-    for (int z = 0; z < depth; z++)
-    {
-        map->grid[z] = (int **)malloc(height * sizeof(int *));
-        for (int y = 0; y < height; y++)
-        {
-            map->grid[z][y] = (int *)malloc(width * sizeof(int));
-            for (int x = 0; x < width; x++)
-            {
-                map->grid[z][y][x] = 0;
-            }
-        }
+    for (int m = 0; m < MAP_MOVE_COUNT; m++) {
+        map->move_delta[m] = map_move_offsets[m].x * step_x +
+                             map_move_offsets[m].y * step_y +
+                             map_move_offsets[m].z * step_z;
     }
 
+    map->origin = layout == MAP_LAYOUT_MORTON
+        ? map_morton_index(map, MAP_PAD, MAP_PAD, MAP_PAD)
+        : MAP_PAD * (map->stride_z + map->stride_y + 1);
+}
+
+// Dimensions, start/exit and empty derived data shared by both storages
+static Map3D *alloc_map_header(int width, int height, int depth, MapLayout layout)
+{
+    Map3D *map = (Map3D *)malloc(sizeof(Map3D));
+    if (!map) return NULL;
+
+    map_set_geometry(map, width, height, depth, layout);
+
+    map->cells = NULL;
+    map->bricks = NULL;
+    map->obstacle_bits = NULL;
+    map->survivor_bits = NULL;
+    map->bitmap_words = 0;
     map->survivors = NULL;
     map->survivor_count = 0;
+    map->survivor_ids = NULL;
+    map->survivor_table = NULL;
+    map->survivor_table_mask = 0;
+    map->risk_field = NULL;
+    map->rubble_sums = NULL;
+    map->detect_offsets = NULL;
+    map->detect_ids = NULL;
+    map->dist_start = NULL;
+    map->dist_exit = NULL;
+    map->dist_survivors = NULL;
+    map->dist_groups = NULL;
+    map->survivor_group = NULL;
+    map->dist_group_count = 0;
+    map->survivor_reachable = NULL;
+    memset(&map->components, 0, sizeof(map->components));
+    map->mapped_base = NULL;
+    map->mapped_size = 0;
 
     map->start_position.x = 0;
     map->start_position.y = 0;
@@ -104,80 +181,252 @@ Map3D *create_map(int width, int height, int depth)
     return map;
 }
 
+Map3D *create_map(int width, int height, int depth)
+{
+    return create_map_with_layout(width, height, depth, MAP_LAYOUT_LINEAR);
+}
+
+Map3D *create_map_with_layout(int width, int height, int depth, MapLayout layout)
+{
+    Map3D *map = alloc_map_header(width, height, depth, layout);
+    if (!map) return NULL;
+
+    // One contiguous, cache-line aligned block of 1-byte cell codes
+    size_t bytes = (map->cell_count + MAP_CACHE_LINE - 1) & ~(size_t)(MAP_CACHE_LINE - 1);
+    if (bytes == 0) bytes = MAP_CACHE_LINE;
+
+    map->cells = (uint8_t *)aligned_alloc(MAP_CACHE_LINE, bytes);
+    if (!map->cells)
+    {
+        free(map);
+        return NULL;
+    }
+    // Everything starts as border; the interior rows are then cleared
+    memset(map->cells, CELL_BORDER, bytes);
+    for (int z = 0; z < depth; z++)
+        for (int y = 0; y < height; y++)
+        {
+            size_t idx = map_index(map, 0, y, z);
+            for (int x = 0; x < width; x++, idx = map_step(map, idx, MAP_MOVE_NEXT_X))
+                map->cells[idx] = CELL_FREE;
+        }
+
+    // Bit-per-voxel views of the grid, plus one spare word so that
+    // map_bits_window() may always read the word after the last one
+    map->bitmap_words = (map->cell_count + 63) / 64;
+    size_t bitmap_bytes = ((map->bitmap_words + 1) * sizeof(uint64_t) + MAP_CACHE_LINE - 1) &
+                          ~(size_t)(MAP_CACHE_LINE - 1);
+
+    map->obstacle_bits = (uint64_t *)aligned_alloc(MAP_CACHE_LINE, bitmap_bytes);
+    map->survivor_bits = (uint64_t *)aligned_alloc(MAP_CACHE_LINE, bitmap_bytes);
+    if (!map->obstacle_bits || !map->survivor_bits)
+    {
+        free(map->obstacle_bits);
+        free(map->survivor_bits);
+        free(map->cells);
+        free(map);
+        return NULL;
+    }
+    memset(map->obstacle_bits, 0, bitmap_bytes);
+    memset(map->survivor_bits, 0, bitmap_bytes);
+    map_rebuild_bitmaps(map);
+
+    return map;
+}
+
+// Same map behind 8x8x8 bricks: no dense cells, bitmaps or per-cell
+// derived arrays, so memory follows the rubble/void boundary
+Map3D *create_sparse_map(int width, int height, int depth)
+{
+    // Bricks address cells by coordinates, so the index stays linear
+    Map3D *map = alloc_map_header(width, height, depth, MAP_LAYOUT_LINEAR);
+    if (!map) return NULL;
+
+    map->bricks = map_bricks_create(width, height, depth);
+    if (!map->bricks)
+    {
+        free(map);
+        return NULL;
+    }
+
+    return map;
+}
+
 // ============================================================
 // 2️⃣ CREATE SURVIVOR CLUSTER - UPDATED
 // ============================================================
-void create_survivor_cluster(Map3D *map, Position center, int cluster_size, int *survivor_index)
+static inline bool is_reserved_cell(const Map3D *map, Position pos)
 {
+    return (pos.x == map->start_position.x &&
+            pos.y == map->start_position.y &&
+            pos.z == map->start_position.z) ||
+           (pos.x == map->exit_position.x &&
+            pos.y == map->exit_position.y &&
+            pos.z == map->exit_position.z);
+}
+
+static void clamp_survivor_sensors(Survivor *s)
+{
+    if (s->heat_signal < MIN_HEAT_C) s->heat_signal = MIN_HEAT_C;
+    if (s->heat_signal > MAX_HEAT_C) s->heat_signal = MAX_HEAT_C;
+    if (s->co2_level < MIN_CO2_PPM) s->co2_level = MIN_CO2_PPM;
+    if (s->co2_level > MAX_CO2_PPM) s->co2_level = MAX_CO2_PPM;
+}
+
+// Places exactly min(cluster_size, free cells in the 5x5x3 box) survivors
+// around center; returns how many were placed
+int create_survivor_cluster(Map3D *map, Rng *rng, Position center, int cluster_size, int *survivor_index)
+{
+    Position candidates[5 * 5 * 3];
+    int candidate_count = 0;
+
+    for (int dz = -1; dz <= 1; dz++)
+        for (int dy = -2; dy <= 2; dy++)
+            for (int dx = -2; dx <= 2; dx++)
+            {
+                Position pos = {center.x + dx, center.y + dy, center.z + dz};
+
+                if (is_valid_position(map, pos) &&
+                    map_cell_at(map, map_pos_index(map, pos)) == CELL_FREE &&
+                    !is_reserved_cell(map, pos) &&
+                    !is_near_edge(map, pos))
+                {
+                    candidates[candidate_count++] = pos;
+                }
+            }
+
+    int needed = cluster_size < candidate_count ? cluster_size : candidate_count;
     int cluster_created = 0;
-    int attempts = 0;
-    int max_attempts = 50;
-    
-    while (cluster_created < cluster_size && attempts < max_attempts)
+
+    // Selection sampling: every subset of `needed` candidates is equally likely
+    for (int i = 0; i < candidate_count && cluster_created < needed; i++)
     {
-        int dx = (rand() % 5) - 2;
-        int dy = (rand() % 5) - 2;
-        int dz = (rand() % 3) - 1;
-        
-        Position pos;
-        pos.x = center.x + dx;
-        pos.y = center.y + dy;
-        pos.z = center.z + dz;
-        
-        if (is_valid_position(map, pos) && 
-            map->grid[pos.z][pos.y][pos.x] == 0 &&
-            !(pos.x == map->start_position.x &&
-              pos.y == map->start_position.y &&
-              pos.z == map->start_position.z) &&
-            !(pos.x == map->exit_position.x &&
-              pos.y == map->exit_position.y &&
-              pos.z == map->exit_position.z) &&
-            !is_near_edge(map, pos))  // ← Fixed: removed EDGE_AVOIDANCE_RADIUS parameter
-        {
-            map->grid[pos.z][pos.y][pos.x] = 2;
-            
-            map->survivors[*survivor_index].pos = pos;
-            map->survivors[*survivor_index].priority = UNIFORM_PRIORITY;
-            map->survivors[*survivor_index].rescued = false;
-            
-            float base_heat = 36.0f + ((float)rand() / RAND_MAX) * 2.0f;
-            float base_co2 = 1500.0f + ((float)rand() / RAND_MAX) * 2500.0f;
-            
-            map->survivors[*survivor_index].heat_signal = base_heat + ((float)rand() / RAND_MAX) * 0.5f - 0.25f;
-            map->survivors[*survivor_index].co2_level = base_co2 + ((float)rand() / RAND_MAX) * 200.0f - 100.0f;
-            map->survivors[*survivor_index].sensor_confidence = 80 + rand() % 15;
-            
-            if (map->survivors[*survivor_index].heat_signal < MIN_HEAT_C) 
-                map->survivors[*survivor_index].heat_signal = MIN_HEAT_C;
-            if (map->survivors[*survivor_index].heat_signal > MAX_HEAT_C) 
-                map->survivors[*survivor_index].heat_signal = MAX_HEAT_C;
-            if (map->survivors[*survivor_index].co2_level < MIN_CO2_PPM) 
-                map->survivors[*survivor_index].co2_level = MIN_CO2_PPM;
-            if (map->survivors[*survivor_index].co2_level > MAX_CO2_PPM) 
-                map->survivors[*survivor_index].co2_level = MAX_CO2_PPM;
-            
-            (*survivor_index)++;
-            cluster_created++;
-        }
-        attempts++;
+        if (rng_bounded(rng, candidate_count - i) >= (uint32_t)(needed - cluster_created))
+            continue;
+
+        Position pos = candidates[i];
+        Survivor *s = &map->survivors[*survivor_index];
+
+        map_set_cell_at(map, map_pos_index(map, pos), CELL_SURVIVOR);
+
+        s->pos = pos;
+        s->priority = UNIFORM_PRIORITY;
+        s->risk = 0.0f;
+        s->rescued = false;
+
+        float base_heat = 36.0f + rng_float(rng) * 2.0f;
+        float base_co2 = 1500.0f + rng_float(rng) * 2500.0f;
+
+        s->heat_signal = base_heat + rng_float(rng) * 0.5f - 0.25f;
+        s->co2_level = base_co2 + rng_float(rng) * 200.0f - 100.0f;
+        s->sensor_confidence = 80 + rng_bounded(rng, 15);
+        clamp_survivor_sensors(s);
+
+        (*survivor_index)++;
+        cluster_created++;
     }
+
+    return cluster_created;
 }
 
 // ============================================================
 // 3️⃣ SIMPLIFIED REALISTIC INITIALIZE MAP
 // ============================================================
-// ============================================================
-// FIXED INITIALIZE MAP - PRINTING ISSUE
-// ============================================================
-// ============================================================
-// FIXED INITIALIZE MAP WITH DEBUGGING
-// ============================================================
+// Placement is exact and O(cells): every floor is scanned once with
+// selection sampling, so the requested counts are always met (as long
+// as there is room) whatever the obstacle ratio. Floors are filled in
+// parallel; each floor draws from its own stream of the global seed,
+// so the map does not depend on the number of threads.
+
+// Rubble density per floor: ground floor densest
+static float floor_density_factor(int z)
+{
+    switch (z) {
+        case 0: return 1.0f;  // Ground: 100%
+        case 1: return 0.8f;  // Floor 1: 80%
+        case 2: return 0.6f;  // Floor 2: 60%
+        case 3: return 0.4f;  // Floor 3: 40%
+        case 4: return 0.2f;  // Floor 4: 20%
+        default: return 0.5f;
+    }
+}
+
+// Free cells of floor z that may receive an obstacle or a survivor
+static long long count_placeable_cells(const Map3D *map, int z)
+{
+    long long free_cells = (long long)map_count_cells(map, z, 1, CELL_FREE);
+
+    if (map->start_position.z == z &&
+        map_cell_at(map, map_pos_index(map, map->start_position)) == CELL_FREE)
+        free_cells--;
+    if (map->exit_position.z == z &&
+        !(map->exit_position.x == map->start_position.x &&
+          map->exit_position.y == map->start_position.y &&
+          map->exit_position.z == map->start_position.z) &&
+        map_cell_at(map, map_pos_index(map, map->exit_position)) == CELL_FREE)
+        free_cells--;
+
+    return free_cells;
+}
+
+// Cells of the 5x5x3 cluster box around pos that are not rubble
+static size_t cluster_box_room(const Map3D *map, Position pos)
+{
+    return map_box_cells(map, pos.x - 2, pos.y - 2, pos.z - 1, pos.x + 2, pos.y + 2, pos.z + 1) -
+           map_count_rubble_box(map, pos.x - 2, pos.y - 2, pos.z - 1, pos.x + 2, pos.y + 2, pos.z + 1);
+}
+
+// Uniform pick among the free, non-edge cells of a floor (reservoir of 1),
+// preferring centers whose box has room for a minimum-size cluster
+static bool pick_cluster_center(const Map3D *map, Rng *rng, int z, Position *center)
+{
+    for (int need_room = 1; need_room >= 0; need_room--)
+    {
+        uint32_t seen = 0;
+
+        for (int y = EDGE_AVOIDANCE_RADIUS; y < map->height - EDGE_AVOIDANCE_RADIUS; y++)
+            for (int x = EDGE_AVOIDANCE_RADIUS; x < map->width - EDGE_AVOIDANCE_RADIUS; x++)
+            {
+                Position pos = {x, y, z};
+                if (map_cell_at(map, map_pos_index(map, pos)) != CELL_FREE || is_reserved_cell(map, pos))
+                    continue;
+                if (need_room && cluster_box_room(map, pos) <= CLUSTER_MIN_SIZE)
+                    continue;
+
+                if (rng_bounded(rng, ++seen) == 0)
+                    *center = pos;
+            }
+
+        if (seen > 0) return true;
+    }
+
+    return false;
+}
+
+// Bulk writes: dense floors write bytes (bitmaps are rebuilt once at the
+// end, so neighbouring floors never race on a shared bitmap word);
+// sparse maps go through the brick table
+static inline void place_cell(Map3D *map, size_t idx, uint8_t type)
+{
+    if (map->cells) map->cells[idx] = type;
+    else map_set_cell_at(map, idx, type);
+}
+
 void initialize_map(Map3D *map, float obstacle_ratio, float survivor_ratio)
 {
     if (!map) return;
 
-    srand(time(NULL));
-    int total_cells = map->width * map->height * map->depth;
+    // Streams come from the global seed alone: the same SEED rebuilds the
+    // same map no matter how many maps the run generated before it
+    const uint64_t stream_base = RNG_STREAM_MAP;
+    uint64_t seed = rng_global_seed();
+    Rng map_rng;
+    rng_seed(&map_rng, seed, stream_base);
+    Rng *rng = &map_rng;
+
+    const int depth = map->depth;
+    const size_t floor_size = (size_t)map->width * map->height;
+    long long total_cells = (long long)map->volume;
 
     printf("\n════════════════════════════════════════════════════════════════\n");
     printf("               SIMPLIFIED REALISTIC DISTRIBUTION               \n");
@@ -187,306 +436,223 @@ void initialize_map(Map3D *map, float obstacle_ratio, float survivor_ratio)
     printf("⚠️  All survivors priority 5\n");
     printf("════════════════════════════════════════════════════════════════\n");
 
+    long long *obstacles_per_floor = (long long *)calloc(depth, sizeof(long long));
+    long long *survivors_per_floor = (long long *)calloc(depth, sizeof(long long));
+    long long *free_per_floor = (long long *)calloc(depth, sizeof(long long));
+    long long *quota_per_floor = (long long *)calloc(depth, sizeof(long long));
+    long long *slot_per_floor = (long long *)calloc(depth, sizeof(long long));
+    double *remainder_per_floor = (double *)calloc(depth, sizeof(double));
+
+    if (!obstacles_per_floor || !survivors_per_floor || !free_per_floor ||
+        !quota_per_floor || !slot_per_floor || !remainder_per_floor) {
+        printf("❌ Memory allocation error for floor statistics\n");
+        goto cleanup;
+    }
+
     // ============================================================
-    // A) FIXED RUBBLE DISTRIBUTION - PROPER PRINTING
+    // A) RUBBLE DISTRIBUTION
     // ============================================================
     printf("\n🧱 Rubble Distribution:\n");
     printf("------------------------\n");
     
-    // First count total obstacles for each floor
-    int obstacles_per_floor[5] = {0};
-    int total_obstacles_planned = 0;
+    long long total_obstacles_planned = 0;
     
-    for (int z = 0; z < map->depth; z++)
+    for (int z = 0; z < depth; z++)
     {
-        float floor_factor;
-        switch(z) {
-            case 0: floor_factor = 1.0f; break;  // Ground: 100%
-            case 1: floor_factor = 0.8f; break;  // Floor 1: 80%
-            case 2: floor_factor = 0.6f; break;  // Floor 2: 60%
-            case 3: floor_factor = 0.4f; break;  // Floor 3: 40%
-            case 4: floor_factor = 0.2f; break;  // Floor 4: 20%
-            default: floor_factor = 0.5f;
-        }
-
+        float floor_factor = floor_density_factor(z);
         float floor_obstacle_ratio = obstacle_ratio * floor_factor;
-        obstacles_per_floor[z] = (int)(map->width * map->height * floor_obstacle_ratio);
+        long long placeable = count_placeable_cells(map, z);
+
+        obstacles_per_floor[z] = (long long)(floor_size * floor_obstacle_ratio);
+        if (obstacles_per_floor[z] > placeable) obstacles_per_floor[z] = placeable;
+        if (obstacles_per_floor[z] < 0) obstacles_per_floor[z] = 0;
+        free_per_floor[z] = placeable;
         total_obstacles_planned += obstacles_per_floor[z];
         
-        printf(" Floor %d: %.0f%% density → %d obstacles\n", 
+        printf(" Floor %d: %.0f%% density → %lld obstacles\n", 
                z, floor_factor * 100, obstacles_per_floor[z]);
     }
     
-    printf(" Total obstacles planned: %d\n", total_obstacles_planned);
+    printf(" Total obstacles planned: %lld\n", total_obstacles_planned);
 
-    // Now actually place the obstacles
-    int total_obstacles_placed = 0;
-    
-    for (int z = 0; z < map->depth; z++)
+    // One pass per floor; floors are independent (bricks span 8 floors,
+    // so sparse maps are filled serially)
+    #pragma omp parallel for schedule(dynamic) if (map->cells)
+    for (int z = 0; z < depth; z++)
     {
-        int obstacles_placed_this_floor = 0;
-        int max_attempts = obstacles_per_floor[z] * 10;
-        int attempts = 0;
-        
-        while (obstacles_placed_this_floor < obstacles_per_floor[z] && attempts < max_attempts)
+        Rng floor_rng;
+        rng_seed(&floor_rng, seed, stream_base + 1 + z);
+
+        long long needed = obstacles_per_floor[z];
+        long long left = free_per_floor[z];
+
+        for (int y = 0; y < map->height && needed > 0; y++)
         {
-            int x = rand() % map->width;
-            int y = rand() % map->height;
-
-            // Avoid placing obstacles at start or exit positions
-            if ((x == map->start_position.x &&
-                 y == map->start_position.y &&
-                 z == map->start_position.z) ||
-                (x == map->exit_position.x &&
-                 y == map->exit_position.y &&
-                 z == map->exit_position.z))
+            size_t idx = map_index(map, 0, y, z);
+            for (int x = 0; x < map->width && needed > 0; x++, idx = map_step(map, idx, MAP_MOVE_NEXT_X))
             {
-                attempts++;
-                continue;
-            }
+                if (map_cell_at(map, idx) != CELL_FREE ||
+                    is_reserved_cell(map, (Position){x, y, z}))
+                    continue;
 
-            // Place obstacle if cell is empty
-            if (map->grid[z][y][x] == 0)
-            {
-                map->grid[z][y][x] = 1;
-                obstacles_placed_this_floor++;
-                total_obstacles_placed++;
+                if ((long long)rng_bounded(&floor_rng, (uint32_t)left) < needed)
+                {
+                    place_cell(map, idx, CELL_OBSTACLE);
+                    needed--;
+                }
+                left--;
             }
-            
-            attempts++;
-        }
-        
-        if (obstacles_placed_this_floor < obstacles_per_floor[z]) {
-            printf("  ⚠️  Floor %d: Only placed %d out of %d obstacles\n", 
-                   z, obstacles_placed_this_floor, obstacles_per_floor[z]);
         }
     }
-    
-    printf(" Total obstacles actually placed: %d\n", total_obstacles_placed);
+    map_rebuild_bitmaps(map);
+
+    // Rubble is final from here on; survivors only fill free cells
+    map_build_rubble_sums(map);
+
+    long long total_obstacles_placed = (long long)map_count_cells(map, 0, depth, CELL_OBSTACLE);
+    printf(" Total obstacles actually placed: %lld\n", total_obstacles_placed);
 
     // ============================================================
-    // B) SURVIVOR DISTRIBUTION - SIMPLIFIED VERSION
+    // B) SURVIVOR DISTRIBUTION
     // ============================================================
-    int max_survivors = (int)(total_cells * survivor_ratio);
+    long long max_survivors = (long long)(total_cells * survivor_ratio);
     if (max_survivors < 1) max_survivors = 1;
     
     map->survivors = (Survivor *)malloc(max_survivors * sizeof(Survivor));
     if (!map->survivors) {
         printf("❌ Memory allocation error for survivors\n");
-        return;
+        goto cleanup;
     }
     
-    printf("\n👥 SIMPLIFIED SURVIVOR DISTRIBUTION (Target: %d):\n", max_survivors);
+    printf("\n👥 SIMPLIFIED SURVIVOR DISTRIBUTION (Target: %lld):\n", max_survivors);
     printf("════════════════════════════════════════════════════════\n");
     
     int survivors_created = 0;
-    int survivors_per_floor[5] = {0};
-    int clusters_per_floor[5] = {0};
+    int clusters_created = 0;
 
-    // Phase 1: Clusters (30% of survivors)
+    // Phase 1: Clusters (30% of survivors), one per floor
     int cluster_target = (int)(max_survivors * 0.3);
     printf("\n🔗 Creating Clusters (30%% = %d survivors):\n", cluster_target);
     
-    for (int floor = 0; floor < map->depth && cluster_target > 0; floor++) {
-        if (cluster_target < CLUSTER_MIN_SIZE) break;
-        
+    for (int floor = 0; floor < depth && cluster_target >= CLUSTER_MIN_SIZE; floor++) {
         Position center;
-        int attempts = 0;
-        int found = 0;
+        if (!pick_cluster_center(map, rng, floor, &center))
+            continue;
+
+        int cluster_size = CLUSTER_MIN_SIZE + rng_bounded(rng, CLUSTER_MAX_SIZE - CLUSTER_MIN_SIZE + 1);
+        if (cluster_size > cluster_target) cluster_size = cluster_target;
         
-        // Try to find a good center position
-        while (!found && attempts < 100) {
-            // Avoid edges for cluster centers
-            center.x = EDGE_AVOIDANCE_RADIUS + rand() % (map->width - 2 * EDGE_AVOIDANCE_RADIUS);
-            center.y = EDGE_AVOIDANCE_RADIUS + rand() % (map->height - 2 * EDGE_AVOIDANCE_RADIUS);
-            center.z = floor;
-            
-            // Check if position is available
-            if (map->grid[center.z][center.y][center.x] == 0 &&
-                !is_near_edge(map, center)) {
-                found = 1;
-            }
-            attempts++;
+        int cluster_created = create_survivor_cluster(map, rng, center, cluster_size, &survivors_created);
+        printf("  Floor %d: Cluster of %d people\n", floor, cluster_created);
+
+        if (cluster_created < cluster_size) {
+            printf("    ⚠️  Only room for %d out of %d cluster members\n", 
+                   cluster_created, cluster_size);
         }
         
-        if (found) {
-            int cluster_size = CLUSTER_MIN_SIZE + rand() % (CLUSTER_MAX_SIZE - CLUSTER_MIN_SIZE + 1);
-            if (cluster_size > cluster_target) cluster_size = cluster_target;
-            
-            if (cluster_size >= CLUSTER_MIN_SIZE) {
-                printf("  Floor %d: Cluster of %d people\n", floor, cluster_size);
-                
-                // Create the cluster
-                int cluster_created = 0;
-                int cluster_attempts = 0;
-                int start_index = survivors_created;
-                
-                // Place cluster members
-                while (cluster_created < cluster_size && cluster_attempts < 100) {
-                    int dx = (rand() % 5) - 2;  // -2 to +2
-                    int dy = (rand() % 5) - 2;  // -2 to +2
-                    
-                    Position pos;
-                    pos.x = center.x + dx;
-                    pos.y = center.y + dy;
-                    pos.z = floor;
-                    
-                    // Check if position is valid and available
-                    if (is_valid_position(map, pos) && 
-                        map->grid[pos.z][pos.y][pos.x] == 0 &&
-                        !(pos.x == map->start_position.x && pos.y == map->start_position.y && pos.z == map->start_position.z) &&
-                        !(pos.x == map->exit_position.x && pos.y == map->exit_position.y && pos.z == map->exit_position.z) &&
-                        !is_near_edge(map, pos)) {
-                        
-                        // Place survivor
-                        map->grid[pos.z][pos.y][pos.x] = 2;
-                        
-                        map->survivors[survivors_created].pos = pos;
-                        map->survivors[survivors_created].priority = UNIFORM_PRIORITY;
-                        map->survivors[survivors_created].rescued = false;
-                        
-                        // Similar sensor data for cluster members
-                        if (cluster_created == 0) {
-                            // First member sets baseline
-                            map->survivors[survivors_created].heat_signal = 36.5f + ((float)rand() / RAND_MAX) * 1.5f - 0.75f;
-                            map->survivors[survivors_created].co2_level = 1500.0f + ((float)rand() / RAND_MAX) * 1500.0f;
-                        } else {
-                            // Other members get similar values
-                            float base_heat = map->survivors[start_index].heat_signal;
-                            float base_co2 = map->survivors[start_index].co2_level;
-                            
-                            map->survivors[survivors_created].heat_signal = base_heat + ((float)rand() / RAND_MAX) * 0.5f - 0.25f;
-                            map->survivors[survivors_created].co2_level = base_co2 + ((float)rand() / RAND_MAX) * 300.0f - 150.0f;
-                        }
-                        
-                        map->survivors[survivors_created].sensor_confidence = 85 + rand() % 10;
-                        
-                        // Ensure within bounds
-                        if (map->survivors[survivors_created].heat_signal < MIN_HEAT_C) 
-                            map->survivors[survivors_created].heat_signal = MIN_HEAT_C;
-                        if (map->survivors[survivors_created].heat_signal > MAX_HEAT_C) 
-                            map->survivors[survivors_created].heat_signal = MAX_HEAT_C;
-                        if (map->survivors[survivors_created].co2_level < MIN_CO2_PPM) 
-                            map->survivors[survivors_created].co2_level = MIN_CO2_PPM;
-                        if (map->survivors[survivors_created].co2_level > MAX_CO2_PPM) 
-                            map->survivors[survivors_created].co2_level = MAX_CO2_PPM;
-                        
-                        survivors_created++;
-                        survivors_per_floor[floor]++;
-                        cluster_created++;
-                    }
-                    
-                    cluster_attempts++;
-                }
-                
-                cluster_target -= cluster_created;
-                clusters_per_floor[floor]++;
-                
-                if (cluster_created < cluster_size) {
-                    printf("    ⚠️  Only placed %d out of %d cluster members\n", 
-                           cluster_created, cluster_size);
-                }
-            }
-        }
+        cluster_target -= cluster_created;
+        clusters_created++;
     }
     
-    printf("✅ Created %d clusters\n", map->depth);
+    printf("✅ Created %d clusters\n", clusters_created);
+
+    // Phase 2: Spread the rest uniformly over the remaining free cells,
+    // stratified by floor (largest-remainder quotas)
+    long long remaining_to_place = max_survivors - survivors_created;
+    long long total_free = 0;
+
+    for (int z = 0; z < depth; z++) {
+        free_per_floor[z] = count_placeable_cells(map, z);
+        total_free += free_per_floor[z];
+    }
+
+    if (remaining_to_place > total_free) {
+        printf("\n⚠️  Only %lld free cells left for %lld survivors\n", total_free, remaining_to_place);
+        remaining_to_place = total_free;
+    }
 
-    // Phase 2: Distribute remaining survivors
     printf("\n📍 Distributing remaining survivors:");
-    
-    int remaining_to_place = max_survivors - survivors_created;
-    
     if (remaining_to_place > 0) {
-        printf(" (need %d more)\n", remaining_to_place);
-        printf("Starting distribution...\n");
+        printf(" (need %lld more)\n", remaining_to_place);
     } else {
         printf(" (no more needed)\n");
     }
-    
-    int placed_in_phase2 = 0;
-    int max_attempts = remaining_to_place * 100;
-    int attempts = 0;
-    
-    while (survivors_created < max_survivors && attempts < max_attempts) {
-        Position pos;
-        pos.z = rand() % map->depth;
-        
-        // Simple distribution: try random position
-        pos.x = rand() % map->width;
-        pos.y = rand() % map->height;
-        
-        // Check if position is available
-        if (map->grid[pos.z][pos.y][pos.x] == 0 &&
-            !(pos.x == map->start_position.x && pos.y == map->start_position.y && pos.z == map->start_position.z) &&
-            !(pos.x == map->exit_position.x && pos.y == map->exit_position.y && pos.z == map->exit_position.z)) {
-            
-            // Place survivor
-            map->grid[pos.z][pos.y][pos.x] = 2;
-            
-            map->survivors[survivors_created].pos = pos;
-            map->survivors[survivors_created].priority = UNIFORM_PRIORITY;
-            map->survivors[survivors_created].rescued = false;
-            map->survivors[survivors_created].heat_signal = 36.5f + ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-            map->survivors[survivors_created].co2_level = 1500.0f + ((float)rand() / RAND_MAX) * 2000.0f;
-            map->survivors[survivors_created].sensor_confidence = 80 + rand() % 15;
-            
-            // Ensure within bounds
-            if (map->survivors[survivors_created].heat_signal < MIN_HEAT_C) 
-                map->survivors[survivors_created].heat_signal = MIN_HEAT_C;
-            if (map->survivors[survivors_created].heat_signal > MAX_HEAT_C) 
-                map->survivors[survivors_created].heat_signal = MAX_HEAT_C;
-            if (map->survivors[survivors_created].co2_level < MIN_CO2_PPM) 
-                map->survivors[survivors_created].co2_level = MIN_CO2_PPM;
-            if (map->survivors[survivors_created].co2_level > MAX_CO2_PPM) 
-                map->survivors[survivors_created].co2_level = MAX_CO2_PPM;
-            
-            survivors_created++;
-            survivors_per_floor[pos.z]++;
-            placed_in_phase2++;
-            
-            // Show progress every 10 survivors
-            if (placed_in_phase2 % 10 == 0) {
-                printf("  Progress: %d/%d placed\n", placed_in_phase2, remaining_to_place);
-            }
+
+    long long assigned = 0;
+    for (int z = 0; z < depth && total_free > 0; z++) {
+        double share = (double)remaining_to_place * free_per_floor[z] / total_free;
+        quota_per_floor[z] = (long long)share;
+        remainder_per_floor[z] = share - quota_per_floor[z];
+        assigned += quota_per_floor[z];
+    }
+    while (assigned < remaining_to_place) {
+        int best = -1;
+        for (int z = 0; z < depth; z++) {
+            if (quota_per_floor[z] < free_per_floor[z] &&
+                (best < 0 || remainder_per_floor[z] > remainder_per_floor[best]))
+                best = z;
         }
-        
-        attempts++;
+        if (best < 0) break;
+        quota_per_floor[best]++;
+        remainder_per_floor[best] = -1.0;
+        assigned++;
     }
-    
-    if (placed_in_phase2 > 0) {
-        printf("✅ Phase 2: Placed %d survivors\n", placed_in_phase2);
+
+    // Each floor writes into its own slice of the survivor array
+    long long next_slot = survivors_created;
+    for (int z = 0; z < depth; z++) {
+        slot_per_floor[z] = next_slot;
+        next_slot += quota_per_floor[z];
     }
-    
-    map->survivor_count = survivors_created;
-    
-    // Emergency placement if needed
-    if (map->survivor_count < max_survivors) {
-        printf("\n⚠️  Emergency placement for %d remaining survivors\n", 
-               max_survivors - map->survivor_count);
-        
-        // Place in any available spot
-        for (int z = 0; z < map->depth && survivors_created < max_survivors; z++) {
-            for (int y = 0; y < map->height && survivors_created < max_survivors; y++) {
-                for (int x = 0; x < map->width && survivors_created < max_survivors; x++) {
-                    if (map->grid[z][y][x] == 0) {
-                        map->grid[z][y][x] = 2;
-                        
-                        map->survivors[survivors_created].pos = (Position){x, y, z};
-                        map->survivors[survivors_created].priority = UNIFORM_PRIORITY;
-                        map->survivors[survivors_created].rescued = false;
-                        map->survivors[survivors_created].heat_signal = 36.5f;
-                        map->survivors[survivors_created].co2_level = 1500.0f;
-                        map->survivors[survivors_created].sensor_confidence = 80;
-                        
-                        survivors_created++;
-                        survivors_per_floor[z]++;
-                    }
+
+    #pragma omp parallel for schedule(dynamic) if (map->cells)
+    for (int z = 0; z < depth; z++)
+    {
+        Rng floor_rng;
+        rng_seed(&floor_rng, seed, stream_base + 1 + (uint64_t)depth + z);
+
+        long long needed = quota_per_floor[z];
+        long long left = free_per_floor[z];
+        long long slot = slot_per_floor[z];
+
+        for (int y = 0; y < map->height && needed > 0; y++)
+        {
+            size_t idx = map_index(map, 0, y, z);
+            for (int x = 0; x < map->width && needed > 0; x++, idx = map_step(map, idx, MAP_MOVE_NEXT_X))
+            {
+                Position pos = {x, y, z};
+                if (map_cell_at(map, idx) != CELL_FREE || is_reserved_cell(map, pos))
+                    continue;
+
+                if ((long long)rng_bounded(&floor_rng, (uint32_t)left) < needed)
+                {
+                    Survivor *s = &map->survivors[slot++];
+
+                    place_cell(map, idx, CELL_SURVIVOR);
+                    s->pos = pos;
+                    s->priority = UNIFORM_PRIORITY;
+                    s->risk = 0.0f;
+                    s->rescued = false;
+                    s->heat_signal = 36.5f + rng_float(&floor_rng) * 2.0f - 1.0f;
+                    s->co2_level = 1500.0f + rng_float(&floor_rng) * 2000.0f;
+                    s->sensor_confidence = 80 + rng_bounded(&floor_rng, 15);
+                    clamp_survivor_sensors(s);
+                    needed--;
                 }
+                left--;
             }
         }
-        map->survivor_count = survivors_created;
     }
+    map_rebuild_bitmaps(map);
+
+    survivors_created = (int)next_slot;
+    map->survivor_count = survivors_created;
+
+    if (remaining_to_place > 0) {
+        printf("✅ Phase 2: Placed %lld survivors\n", remaining_to_place);
+    }
+
+    map_build_derived_data(map);
 
     // ============================================================
     // C) FINAL STATISTICS
@@ -512,7 +678,7 @@ void initialize_map(Map3D *map, float obstacle_ratio, float survivor_ratio)
     printf("\n📊 DISTRIBUTION STATISTICS:\n");
     printf("════════════════════════════════════\n");
     printf("Total Survivors:        %d\n", map->survivor_count);
-    printf("Total Obstacles:        %d\n", total_obstacles_placed);
+    printf("Total Obstacles:        %lld\n", total_obstacles_placed);
     
     printf("\n📍 Survivors by Location:\n");
     printf("  Central Area:         %d (%.1f%%)\n", 
@@ -523,22 +689,27 @@ void initialize_map(Map3D *map, float obstacle_ratio, float survivor_ratio)
            other_count, (float)other_count/map->survivor_count*100);
     
     printf("\n🏢 Survivors by Floor:\n");
-    for (int z = 0; z < map->depth; z++) {
-        // Count obstacles on this floor
-        int floor_obstacles = 0;
-        for (int y = 0; y < map->height; y++) {
-            for (int x = 0; x < map->width; x++) {
-                if (map->grid[z][y][x] == 1) floor_obstacles++;
-            }
-        }
+    for (int z = 0; z < depth; z++) {
+        long long floor_obstacles = (long long)map_count_cells(map, z, 1, CELL_OBSTACLE);
+        survivors_per_floor[z] = (long long)map_count_cells(map, z, 1, CELL_SURVIVOR);
         
         float percentage = (float)survivors_per_floor[z] / map->survivor_count * 100.0f;
-        printf("  Floor %d:             %d survivors (%.1f%%) | %d obstacles\n", 
+        printf("  Floor %d:             %lld survivors (%.1f%%) | %lld obstacles\n", 
                z, survivors_per_floor[z], percentage, floor_obstacles);
     }
     
+    print_map_reachability(map);
+    
     printf("\n✅ SIMPLIFIED REALISTIC map created successfully!\n");
     printf("════════════════════════════════════════════════════════════════\n");
+
+cleanup:
+    free(obstacles_per_floor);
+    free(survivors_per_floor);
+    free(free_per_floor);
+    free(quota_per_floor);
+    free(slot_per_floor);
+    free(remainder_per_floor);
 }
 // ============================================================
 // 3️⃣ LOAD SETTINGS FROM FILE
@@ -561,6 +732,19 @@ Settings *load_settings(const char *filename)
     char key[100], value[100];
     int settings_loaded = 0;
 
+    // Defaults for keys the file may leave out
+    memset(settings, 0, sizeof(Settings));
+    settings->map_layout = MAP_LAYOUT_LINEAR;
+    settings->num_robots = 1;
+    settings->population_size = 50;
+    settings->generations = 100;
+    settings->tournament_size = 3;
+    settings->crossover_rate = 0.8f;
+    settings->mutation_rate = 0.01f;
+    settings->elitism_rate = 0.1f;
+    settings->max_path_length = 50;
+    settings->log_level = 1;
+
     while (fgets(line, sizeof(line), file))
     {
         if (line[0] == '\n' || line[0] == '#')
@@ -585,13 +769,27 @@ Settings *load_settings(const char *filename)
             else if (strcmp(k, "MAP_DEPTH") == 0) settings->map_depth = atoi(v);
             else if (strcmp(k, "OBSTACLE_RATIO") == 0) settings->obstacle_ratio = atof(v);
             else if (strcmp(k, "SURVIVOR_RATIO") == 0) settings->survivor_ratio = atof(v);
+            else if (strcmp(k, "MAP_LAYOUT") == 0)
+                settings->map_layout = strcmp(v, "morton") == 0 ? MAP_LAYOUT_MORTON : MAP_LAYOUT_LINEAR;
             else if (strcmp(k, "NUM_ROBOTS") == 0) settings->num_robots = atoi(v);
+            else if (strcmp(k, "ROBOT_START_X") == 0) settings->robot_start.x = atoi(v);
+            else if (strcmp(k, "ROBOT_START_Y") == 0) settings->robot_start.y = atoi(v);
+            else if (strcmp(k, "ROBOT_START_Z") == 0) settings->robot_start.z = atoi(v);
             else if (strcmp(k, "POPULATION_SIZE") == 0) settings->population_size = atoi(v);
             else if (strcmp(k, "GENERATIONS") == 0) settings->generations = atoi(v);
+            else if (strcmp(k, "TOURNAMENT_SIZE") == 0) settings->tournament_size = atoi(v);
+            else if (strcmp(k, "CROSSOVER_RATE") == 0) settings->crossover_rate = atof(v);
+            else if (strcmp(k, "MUTATION_RATE") == 0) settings->mutation_rate = atof(v);
+            else if (strcmp(k, "ELITISM_RATE") == 0) settings->elitism_rate = atof(v);
             else if (strcmp(k, "W_SURVIVORS") == 0) settings->w_survivors = atof(v);
+            else if (strcmp(k, "W_COVERAGE") == 0) settings->w_coverage = atof(v);
             else if (strcmp(k, "W_LENGTH") == 0) settings->w_length = atof(v);
             else if (strcmp(k, "W_RISK") == 0) settings->w_risk = atof(v);
             else if (strcmp(k, "OUTPUT_FILE") == 0) strcpy(settings->output_file, v);
+            else if (strcmp(k, "SEED") == 0) settings->seed = strtoull(v, NULL, 10);
+            else if (strcmp(k, "NUM_WORKERS") == 0) settings->num_workers = atoi(v);
+            else if (strcmp(k, "MAX_PATH_LENGTH") == 0) settings->max_path_length = atoi(v);
+            else if (strcmp(k, "LOG_LEVEL") == 0) settings->log_level = atoi(v);
             
             settings_loaded = 1;
         }
@@ -631,6 +829,7 @@ void print_settings(const Settings *settings)
            settings->map_width, settings->map_height, settings->map_depth);
     printf("  Obstacle ratio: %.2f\n", settings->obstacle_ratio);
     printf("  Survivor ratio: %.2f\n", settings->survivor_ratio);
+    printf("  Cell layout: %s\n", settings->map_layout == MAP_LAYOUT_MORTON ? "morton" : "linear");
     printf("\n");
 
     printf("Distribution Improvements:\n");
@@ -644,10 +843,15 @@ void print_settings(const Settings *settings)
     printf("Genetic Algorithm Settings:\n");
     printf("  Population size: %d\n", settings->population_size);
     printf("  Number of generations: %d\n", settings->generations);
+    printf("  Tournament size: %d\n", settings->tournament_size);
+    printf("  Crossover / mutation / elitism: %.2f / %.3f / %.2f\n",
+           settings->crossover_rate, settings->mutation_rate, settings->elitism_rate);
+    printf("  Max path length: %d moves\n", settings->max_path_length);
     printf("\n");
 
     printf("Fitness Function Weights:\n");
     printf("  Survivors weight: %.2f\n", settings->w_survivors);
+    printf("  Coverage weight: %.2f\n", settings->w_coverage);
     printf("  Path length weight: %.2f\n", settings->w_length);
     printf("  Risk weight: %.2f\n", settings->w_risk);
     printf("\n");
@@ -666,18 +870,225 @@ void print_settings(const Settings *settings)
 void free_map(Map3D *map) {
     if (!map) return;
     
-    for (int z = 0; z < map->depth; z++) {
-        for (int y = 0; y < map->height; y++) {
-            free(map->grid[z][y]);
-        }
-        free(map->grid[z]);
-    }
-    free(map->grid);
+    map_release_buffer(map, map->cells);
+    map_bricks_free(map->bricks);
+    map_release_buffer(map, map->obstacle_bits);
+    map_release_buffer(map, map->survivor_bits);
+    
+    map_release_buffer(map, map->survivors);
+    map_release_buffer(map, map->survivor_ids);
+    map_release_buffer(map, map->survivor_table);
+    map_release_buffer(map, map->risk_field);
+    map_release_buffer(map, map->rubble_sums);
+    map_release_buffer(map, map->detect_offsets);
+    map_release_buffer(map, map->detect_ids);
+    map_release_buffer(map, map->dist_start);
+    map_release_buffer(map, map->dist_exit);
+    map_release_buffer(map, map->dist_survivors);
+    map_release_buffer(map, map->dist_groups);
+    map_release_buffer(map, map->survivor_group);
+    map_release_buffer(map, map->survivor_reachable);
     
-    if (map->survivors) free(map->survivors);
+    if (map->mapped_base) munmap(map->mapped_base, map->mapped_size);
     free(map);
 }
 
+// Free a map buffer unless it lives inside a memory-mapped snapshot
+void map_release_buffer(const Map3D *map, void *ptr)
+{
+    if (!ptr) return;
+
+    if (map->mapped_base &&
+        (const char *)ptr >= (const char *)map->mapped_base &&
+        (const char *)ptr < (const char *)map->mapped_base + map->mapped_size)
+        return;
+
+    free(ptr);
+}
+
+// Convert a cell index back to coordinates (border cells map to -1 or
+// width/height/depth and beyond)
+Position map_index_to_position(const Map3D *map, size_t idx)
+{
+    Position pos;
+    if (map->layout == MAP_LAYOUT_MORTON)
+    {
+        size_t block = idx >> MAP_MORTON_BITS;
+        pos.x = (int)(((block % map->blocks_x) << MAP_MORTON_SHIFT) | map_morton_compact(idx)) - MAP_PAD;
+        block /= map->blocks_x;
+        pos.y = (int)(((block % map->blocks_y) << MAP_MORTON_SHIFT) | map_morton_compact(idx >> 1)) - MAP_PAD;
+        pos.z = (int)(((block / map->blocks_y) << MAP_MORTON_SHIFT) | map_morton_compact(idx >> 2)) - MAP_PAD;
+        return pos;
+    }
+
+    pos.x = (int)(idx % map->stride_y) - MAP_PAD;
+    idx /= map->stride_y;
+    pos.y = (int)(idx % (map->stride_z / map->stride_y)) - MAP_PAD;
+    pos.z = (int)(idx / (map->stride_z / map->stride_y)) - MAP_PAD;
+    return pos;
+}
+
+// Read a cell code; out-of-bounds reads behave like rubble
+uint8_t map_get_cell(const Map3D *map, Position pos)
+{
+    if (!is_valid_position(map, pos))
+        return CELL_OBSTACLE;
+    return map_cell_at(map, map_pos_index(map, pos));
+}
+
+// Single write path for cell codes; keeps the bitmaps in sync
+void map_set_cell_at(Map3D *map, size_t idx, uint8_t type)
+{
+    size_t word = idx >> 6;
+    uint64_t bit = 1ULL << (idx & 63);
+
+    // Memory-mapped snapshots are read-only
+    if (map->mapped_base) return;
+
+    if (map->bricks)
+    {
+        Position pos = map_index_to_position(map, idx);
+        if (is_valid_position(map, pos))
+            map_brick_set(map->bricks, pos.x, pos.y, pos.z, type);
+        return;
+    }
+
+    // The border is fixed once the grid is allocated
+    if (map->cells[idx] == CELL_BORDER) return;
+    map->cells[idx] = type;
+
+    if (type == CELL_OBSTACLE) map->obstacle_bits[word] |= bit;
+    else map->obstacle_bits[word] &= ~bit;
+
+    if (type == CELL_SURVIVOR) map->survivor_bits[word] |= bit;
+    else map->survivor_bits[word] &= ~bit;
+}
+
+// Recompute both bitmaps from the byte grid after bulk writes to cells[]
+void map_rebuild_bitmaps(Map3D *map)
+{
+    if (map->mapped_base || !map->cells) return;
+
+    #pragma omp parallel for schedule(static)
+    for (size_t w = 0; w < map->bitmap_words; w++)
+    {
+        size_t first = w << 6;
+        size_t count = map->cell_count - first < 64 ? map->cell_count - first : 64;
+        uint64_t obstacles = 0, survivors = 0;
+
+        for (size_t b = 0; b < count; b++)
+        {
+            uint8_t cell = map->cells[first + b];
+            obstacles |= (uint64_t)(cell & 1u) << b;
+            survivors |= (uint64_t)(cell == CELL_SURVIVOR) << b;
+        }
+        map->obstacle_bits[w] = obstacles;
+        map->survivor_bits[w] = survivors;
+    }
+}
+
+void map_set_cell(Map3D *map, Position pos, uint8_t type)
+{
+    if (!is_valid_position(map, pos))
+        return;
+    map_set_cell_at(map, map_pos_index(map, pos), type);
+}
+
+static inline bool cell_occupied(const Map3D *map, size_t idx, bool include_survivors)
+{
+    return map_is_obstacle_at(map, idx) ||
+           (include_survivors && map_has_survivor_at(map, idx));
+}
+
+// Blocked-direction mask for the 6 axis neighbours of a cell (bit order
+// follows Direction: +x, -x, +y, -y, +z, -z; bit 6 is the cell itself).
+// The border is blocked like rubble, so no bounds checks are needed; the
+// x neighbours come from a single 64-bit window per bitmap.
+unsigned map_blocked_neighbors(const Map3D *map, Position pos, bool include_survivors)
+{
+    size_t idx = map_pos_index(map, pos);
+
+    // bit 0 = x-1, bit 1 = x, bit 2 = x+1
+    uint64_t near;
+    if (!map->obstacle_bits || map->layout != MAP_LAYOUT_LINEAR)
+    {
+        near = (uint64_t)cell_occupied(map, map_step(map, idx, 1), include_survivors) |
+               (uint64_t)cell_occupied(map, idx, include_survivors) << 1 |
+               (uint64_t)cell_occupied(map, map_step(map, idx, 0), include_survivors) << 2;
+    }
+    else
+    {
+        near = map_bits_window(map->obstacle_bits, idx - 1);
+        if (include_survivors)
+            near |= map_bits_window(map->survivor_bits, idx - 1);
+    }
+
+    unsigned mask = 0;
+    if (near & 4) mask |= 1u << 0;
+    if (near & 1) mask |= 1u << 1;
+    for (int m = 2; m < 6; m++)
+        if (cell_occupied(map, map_step(map, idx, m), include_survivors)) mask |= 1u << m;
+    if (near & 2) mask |= 1u << 6;
+
+    return mask;
+}
+
+// Population count over a bit span, one word at a time
+size_t map_count_bits(const uint64_t *bits, size_t first, size_t count)
+{
+    if (count == 0) return 0;
+
+    size_t last = first + count;         // exclusive
+    size_t w0 = first >> 6;
+    size_t w1 = (last - 1) >> 6;
+    uint64_t head = ~0ULL << (first & 63);
+    uint64_t tail = ~0ULL >> (63 - ((last - 1) & 63));
+
+    if (w0 == w1)
+        return (size_t)__builtin_popcountll(bits[w0] & head & tail);
+
+    size_t total = (size_t)__builtin_popcountll(bits[w0] & head);
+    for (size_t w = w0 + 1; w < w1; w++)
+        total += (size_t)__builtin_popcountll(bits[w]);
+    total += (size_t)__builtin_popcountll(bits[w1] & tail);
+    return total;
+}
+
+// Counts interior rows only, so the border never shows up as rubble
+size_t map_count_cells(const Map3D *map, int z_first, int z_count, uint8_t type)
+{
+    if (map->bricks)
+        return map_bricks_count_cells(map, z_first, z_count, type);
+
+    const size_t row = (size_t)map->width;
+    size_t total = 0;
+
+    for (int z = z_first; z < z_first + z_count; z++)
+    {
+        for (int y = 0; y < map->height; y++)
+        {
+            size_t first = map_index(map, 0, y, z);
+
+            // Morton rows are scattered; test cell by cell
+            if (map->layout != MAP_LAYOUT_LINEAR)
+            {
+                size_t idx = first;
+                for (int x = 0; x < map->width; x++, idx = map_step(map, idx, MAP_MOVE_NEXT_X))
+                    total += map->cells[idx] == type;
+            }
+            else if (type == CELL_OBSTACLE) total += map_count_bits(map->obstacle_bits, first, row);
+            else if (type == CELL_SURVIVOR) total += map_count_bits(map->survivor_bits, first, row);
+            else if (type == CELL_FREE)
+                total += row - map_count_bits(map->obstacle_bits, first, row) -
+                         map_count_bits(map->survivor_bits, first, row);
+            else
+                for (size_t i = first; i < first + row; i++)
+                    total += map->cells[i] == type;
+        }
+    }
+    return total;
+}
+
 // Check if position is valid
 bool is_valid_position(const Map3D *map, Position pos)
 {
@@ -691,7 +1102,7 @@ bool is_obstacle(const Map3D *map, Position pos)
 {
     if (!is_valid_position(map, pos))
         return true;
-    return (map->grid[pos.z][pos.y][pos.x] == 1);
+    return map_is_obstacle_at(map, map_pos_index(map, pos));
 }
 
 // Check if position has survivor
@@ -699,25 +1110,214 @@ bool is_survivor(const Map3D *map, Position pos)
 {
     if (!is_valid_position(map, pos))
         return false;
-    return (map->grid[pos.z][pos.y][pos.x] == 2);
+    return map_has_survivor_at(map, map_pos_index(map, pos));
 }
 
 // Get survivor at specific position
 Survivor *get_survivor_at(const Map3D *map, Position pos)
 {
-    if (!is_survivor(map, pos))
+    if (!is_valid_position(map, pos))
         return NULL;
 
-    for (int i = 0; i < map->survivor_count; i++)
+    int id = map_survivor_id_at(map, map_pos_index(map, pos));
+    return id >= 0 ? &map->survivors[id] : NULL;
+}
+
+// Obstacles in the 5x5x5 box around pos: O(1) from the summed-volume table
+int count_nearby_rubble(const Map3D *map, Position pos)
+{
+    const int r = RUBBLE_QUERY_RADIUS;
+    return (int)map_count_rubble_box(map, pos.x - r, pos.y - r, pos.z - r, pos.x + r, pos.y + r, pos.z + r);
+}
+
+// Local rubble density relative to the building average, on a 1..10
+// scale where 5 means "as dense as the rest of the building"
+int calculate_unique_priority(const Map3D *map, Position pos, float base_rubble_density)
+{
+    const int r = RUBBLE_QUERY_RADIUS;
+    size_t cells = map_box_cells(map, pos.x - r, pos.y - r, pos.z - r, pos.x + r, pos.y + r, pos.z + r);
+    if (cells == 0) return UNIFORM_PRIORITY;
+
+    float local = (float)count_nearby_rubble(map, pos) / (float)cells;
+    int priority = base_rubble_density > 0.0f
+        ? (int)lroundf(UNIFORM_PRIORITY * local / base_rubble_density)
+        : 1 + (int)lroundf(9.0f * local);
+
+    if (priority < 1) priority = 1;
+    if (priority > 10) priority = 10;
+    return priority;
+}
+
+float calculate_risk_from_priority(int priority)
+{
+    if (priority < 1) priority = 1;
+    if (priority > 10) priority = 10;
+    return priority / 10.0f;
+}
+
+// Build every lookup structure derived from a finished map
+void map_build_derived_data(Map3D *map)
+{
+    if (!map) return;
+
+    map_bump_serial(map);
+    map_build_survivor_index(map);
+    map_label_components(map);
+
+    // Per-cell tables would undo the savings of sparse storage; risk and
+    // detection are then computed on demand from the bricks
+    if (map->bricks) return;
+
+    if (!map->rubble_sums) map_build_rubble_sums(map);
+    map_build_risk_field(map);
+    map_build_detection_lists(map);
+    map_build_distance_fields(map);
+}
+
+// Closest CELL_FREE cell to pos other than pos itself, searched in growing
+// Manhattan shells so large maps stop at the first free neighbour
+static bool nearest_free_cell(const Map3D *map, Position pos, Position *out)
+{
+    int max_d = map->width + map->height + map->depth;
+
+    for (int d = 1; d <= max_d; d++)
+        for (int dz = -d; dz <= d; dz++) {
+            int rest_z = d - abs(dz);
+            for (int dy = -rest_z; dy <= rest_z; dy++) {
+                int rest_y = rest_z - abs(dy);
+                for (int side = 0; side < (rest_y ? 2 : 1); side++) {
+                    Position p = { pos.x + (side ? rest_y : -rest_y), pos.y + dy, pos.z + dz };
+                    if (is_valid_position(map, p) && map_get_cell(map, p) == CELL_FREE) {
+                        *out = p;
+                        return true;
+                    }
+                }
+            }
+        }
+    return false;
+}
+
+// The start cell is reserved during generation and anchors reachability,
+// detection lists and dist_start, so it is set before initialize_map;
+// on a map that already has that data it is rebuilt for the new start
+bool map_set_start_position(Map3D *map, Position start)
+{
+    if (!map) return false;
+
+    if (!is_valid_position(map, start))
+    {
+        printf("⚠️  Start (%d,%d,%d) is outside the map; keeping (%d,%d,%d)\n",
+               start.x, start.y, start.z,
+               map->start_position.x, map->start_position.y, map->start_position.z);
+        return false;
+    }
+    if (map->survivor_reachable && is_obstacle(map, start))
     {
-        if (map->survivors[i].pos.x == pos.x &&
-            map->survivors[i].pos.y == pos.y &&
-            map->survivors[i].pos.z == pos.z)
+        printf("⚠️  Start (%d,%d,%d) is inside rubble; keeping the current start\n",
+               start.x, start.y, start.z);
+        return false;
+    }
+
+    if (map->exit_position.x == start.x &&
+        map->exit_position.y == start.y &&
+        map->exit_position.z == start.z) {
+        Position exit;
+        if (!nearest_free_cell(map, start, &exit)) {
+            printf("⚠️  No free cell left for the exit; keeping the current start\n");
+            return false;
+        }
+        map->exit_position = exit;
+        printf("Exit location adjusted to avoid interference with start position\n");
+    }
+    map->start_position = start;
+
+    if (!map->survivor_reachable) return true;
+
+    map_bump_serial(map);
+    map_label_components(map);
+    if (!map->bricks) {
+        map_build_detection_lists(map);
+        map_build_distance_fields(map);
+    }
+    return true;
+}
+
+// ============================================================
+// 5️⃣.1 SURVIVOR INDEX (cell -> survivor id)
+// ============================================================
+static inline size_t survivor_slot_hash(uint64_t cell, size_t mask)
+{
+    return (size_t)((cell * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+void map_build_survivor_index(Map3D *map)
+{
+    if (!map) return;
+
+    map_release_buffer(map, map->survivor_ids);
+    map_release_buffer(map, map->survivor_table);
+    map->survivor_ids = NULL;
+    map->survivor_table = NULL;
+    map->survivor_table_mask = 0;
+
+    if (!map->bricks &&
+        (size_t)map->survivor_count * SURVIVOR_DENSE_INDEX_RATIO >= map->cell_count)
+    {
+        map->survivor_ids = (int32_t *)malloc(map->cell_count * sizeof(int32_t));
+        if (!map->survivor_ids)
         {
-            return &map->survivors[i];
+            printf("❌ Memory allocation error for survivor index\n");
+            return;
         }
+        memset(map->survivor_ids, 0xFF, map->cell_count * sizeof(int32_t));
+
+        for (int i = 0; i < map->survivor_count; i++)
+            map->survivor_ids[map_pos_index(map, map->survivors[i].pos)] = i;
+        return;
+    }
+
+    // Load factor <= 0.5
+    size_t capacity = 16;
+    while (capacity < (size_t)map->survivor_count * 2) capacity <<= 1;
+
+    map->survivor_table = (SurvivorSlot *)malloc(capacity * sizeof(SurvivorSlot));
+    if (!map->survivor_table)
+    {
+        printf("❌ Memory allocation error for survivor index\n");
+        return;
+    }
+    for (size_t i = 0; i < capacity; i++)
+    {
+        map->survivor_table[i].cell = SURVIVOR_SLOT_EMPTY;
+        map->survivor_table[i].id = -1;
+    }
+    map->survivor_table_mask = capacity - 1;
+
+    for (int i = 0; i < map->survivor_count; i++)
+    {
+        uint64_t cell = map_pos_index(map, map->survivors[i].pos);
+        size_t slot = survivor_slot_hash(cell, map->survivor_table_mask);
+        while (map->survivor_table[slot].cell != SURVIVOR_SLOT_EMPTY &&
+               map->survivor_table[slot].cell != cell)
+            slot = (slot + 1) & map->survivor_table_mask;
+
+        map->survivor_table[slot].cell = cell;
+        map->survivor_table[slot].id = i;
     }
-    return NULL;
+}
+
+int map_lookup_survivor_slot(const Map3D *map, size_t idx)
+{
+    if (!map->survivor_table) return -1;
+
+    size_t slot = survivor_slot_hash(idx, map->survivor_table_mask);
+    while (map->survivor_table[slot].cell != SURVIVOR_SLOT_EMPTY)
+    {
+        if (map->survivor_table[slot].cell == idx)
+            return map->survivor_table[slot].id;
+        slot = (slot + 1) & map->survivor_table_mask;
+    }
+    return -1;
 }
 
 // ============================================================
@@ -757,17 +1357,34 @@ void print_map(const Map3D *map)
         int floor_central = 0;
         int floor_edge = 0;
         
-        for (int y = 0; y < map->height; y++) {
-            for (int x = 0; x < map->width; x++) {
-                if (map->grid[z][y][x] == 1) floor_obstacles++;
-                else if (map->grid[z][y][x] == 2) {
-                    floor_survivors++;
-                    Position pos = {x, y, z};
-                    if (is_in_central_area(map, pos)) floor_central++;
-                    if (is_near_edge(map, pos)) floor_edge++;  // ← Fixed: removed parameter
-                }
+        size_t floor_first = map_index(map, 0, 0, z);
+        size_t floor_last = map_index(map, map->width - 1, map->height - 1, z);
+        floor_obstacles = (int)map_count_cells(map, z, 1, CELL_OBSTACLE);
+
+        // Visit only the set survivor bits of this floor (the border
+        // cells in between never carry one)
+        bool linear_bits = map->survivor_bits && map->layout == MAP_LAYOUT_LINEAR;
+        for (size_t w = floor_first >> 6; linear_bits && w <= floor_last >> 6; w++) {
+            uint64_t word = map->survivor_bits[w];
+            while (word) {
+                size_t idx = (w << 6) + (size_t)__builtin_ctzll(word);
+                word &= word - 1;
+                if (idx < floor_first || idx > floor_last) continue;
+
+                floor_survivors++;
+                Position pos = map_index_to_position(map, idx);
+                if (is_in_central_area(map, pos)) floor_central++;
+                if (is_near_edge(map, pos)) floor_edge++;
             }
         }
+        for (int i = 0; !linear_bits && i < map->survivor_count; i++) {
+            Position pos = map->survivors[i].pos;
+            if (pos.z != z) continue;
+
+            floor_survivors++;
+            if (is_in_central_area(map, pos)) floor_central++;
+            if (is_near_edge(map, pos)) floor_edge++;
+        }
         
         printf("┌─ Survivors: %2d (Central: %d, Edge: %d) | Obstacles: %3d ─┐\n", 
                floor_survivors, floor_central, floor_edge, floor_obstacles);
@@ -891,9 +1508,9 @@ void save_map_to_file(const Map3D *map, const char *filename)
         {
             for (int x = 0; x < map->width; x++)
             {
-                int cell_type = map->grid[z][y][x];
+                int cell_type = map_cell_at(map, map_index(map, x, y, z));
 
-                if (cell_type == 2)  // Survivor
+                if (cell_type == CELL_SURVIVOR)
                 {
                     Survivor *s = get_survivor_at(map, (Position){x, y, z});
                     if (s)
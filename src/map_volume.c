@@ -0,0 +1,119 @@
+#include "map_volume.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// SUMMED-VOLUME TABLE OF RUBBLE
+// ============================================================
+// One extra zero plane on each low face, so a box count is always the
+// same 8-term inclusion-exclusion. Floors are prefixed in 2D in
+// parallel, then the planes are accumulated along z in parallel rows.
+// Entries are 32-bit; maps with more cells than that keep no table and
+// queries fall back to scanning.
+
+size_t map_rubble_sums_length(const Map3D *map)
+{
+    return ((size_t)map->width + 1) * ((size_t)map->height + 1) * ((size_t)map->depth + 1);
+}
+
+static inline size_t sum_index(const Map3D *map, int x, int y, int z)
+{
+    return ((size_t)z * (map->height + 1) + y) * (map->width + 1) + x;
+}
+
+bool map_build_rubble_sums(Map3D *map)
+{
+    if (!map) return false;
+
+    map_release_buffer(map, map->rubble_sums);
+    map->rubble_sums = NULL;
+    if (map->volume > UINT32_MAX) return false;
+
+    uint32_t *sums = (uint32_t *)malloc(map_rubble_sums_length(map) * sizeof(uint32_t));
+    if (!sums) {
+        printf("❌ Memory allocation error for rubble sums\n");
+        return false;
+    }
+
+    const int width = map->width;
+    const int height = map->height;
+    const int depth = map->depth;
+    const size_t plane = ((size_t)width + 1) * (height + 1);
+
+    memset(sums, 0, plane * sizeof(uint32_t));
+
+    // Pass 1: 2D prefix sums of each floor
+    #pragma omp parallel for schedule(static)
+    for (int z = 0; z < depth; z++) {
+        uint32_t *floor = sums + (size_t)(z + 1) * plane;
+        memset(floor, 0, ((size_t)width + 1) * sizeof(uint32_t));
+
+        for (int y = 0; y < height; y++) {
+            uint32_t *row = floor + (size_t)(y + 1) * (width + 1);
+            const uint32_t *above = row - (width + 1);
+            size_t idx = map_index(map, 0, y, z);
+            uint32_t run = 0;
+
+            row[0] = 0;
+            for (int x = 0; x < width; x++, idx = map_step(map, idx, MAP_MOVE_NEXT_X)) {
+                run += map_cell_at(map, idx) == CELL_OBSTACLE;
+                row[x + 1] = above[x + 1] + run;
+            }
+        }
+    }
+
+    // Pass 2: accumulate the floors along z, rows in parallel
+    #pragma omp parallel for schedule(static)
+    for (int y = 1; y <= height; y++) {
+        for (int z = 2; z <= depth; z++) {
+            uint32_t *row = sums + (size_t)z * plane + (size_t)y * (width + 1);
+            const uint32_t *below = row - plane;
+            for (int x = 1; x <= width; x++)
+                row[x] += below[x];
+        }
+    }
+
+    map->rubble_sums = sums;
+    return true;
+}
+
+// Clamp [lo, hi] to [0, limit - 1]; false when nothing is left
+static inline bool clamp_span(int *lo, int *hi, int limit)
+{
+    if (*lo < 0) *lo = 0;
+    if (*hi > limit - 1) *hi = limit - 1;
+    return *lo <= *hi;
+}
+
+size_t map_box_cells(const Map3D *map, int x0, int y0, int z0, int x1, int y1, int z1)
+{
+    if (!clamp_span(&x0, &x1, map->width) || !clamp_span(&y0, &y1, map->height) ||
+        !clamp_span(&z0, &z1, map->depth))
+        return 0;
+    return (size_t)(x1 - x0 + 1) * (size_t)(y1 - y0 + 1) * (size_t)(z1 - z0 + 1);
+}
+
+size_t map_count_rubble_box(const Map3D *map, int x0, int y0, int z0, int x1, int y1, int z1)
+{
+    if (!clamp_span(&x0, &x1, map->width) || !clamp_span(&y0, &y1, map->height) ||
+        !clamp_span(&z0, &z1, map->depth))
+        return 0;
+
+    if (!map->rubble_sums) {
+        size_t total = 0;
+        for (int z = z0; z <= z1; z++)
+            for (int y = y0; y <= y1; y++)
+                for (int x = x0; x <= x1; x++)
+                    total += map_cell_at(map, map_index(map, x, y, z)) == CELL_OBSTACLE;
+        return total;
+    }
+
+    const uint32_t *s = map->rubble_sums;
+    x1++; y1++; z1++;
+    int64_t total = (int64_t)s[sum_index(map, x1, y1, z1)]
+                  - s[sum_index(map, x0, y1, z1)] - s[sum_index(map, x1, y0, z1)] - s[sum_index(map, x1, y1, z0)]
+                  + s[sum_index(map, x0, y0, z1)] + s[sum_index(map, x0, y1, z0)] + s[sum_index(map, x1, y0, z0)]
+                  - s[sum_index(map, x0, y0, z0)];
+    return (size_t)total;
+}
@@ -0,0 +1,495 @@
+#include "path_batch.h"
+#include "map_fields.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EVAL_BATCH_X86 1
+#endif
+
+// ============================================================
+// LOCKSTEP BATCH EVALUATION
+// ============================================================
+// A group of EVAL_BATCH_LANES paths is walked move by move in vector
+// registers, one path per 32-bit lane. Each step reproduces eval_walk:
+//   - genes above WAIT decode as WAIT,
+//   - a move that hits rubble or the border clears the valid mask,
+//   - a move into the border is dropped (masked bounds clamp),
+//   - length counts the moves actually taken, risk sums every position.
+// Lanes whose path is shorter than the group's longest are masked out.
+//
+// Coverage and survivors need a visited set per path, which does not
+// map onto lanes, so the walk writes the cell of every position to a
+// move-major tile and each path is then counted with the stamp buffers.
+// Risk is summed in path order per lane, so totals match the scalar
+// kernel exactly.
+
+typedef struct {
+    int lanes;                                  // paths in the group
+    int max_moves;
+    int32_t num_moves[EVAL_BATCH_LANES];        // -1 = unused lane
+    int32_t x[EVAL_BATCH_LANES], y[EVAL_BATCH_LANES], z[EVAL_BATCH_LANES];
+    int32_t idx[EVAL_BATCH_LANES];              // start cell
+    const Gene *genes;                          // EVAL_BATCH_LANES genes per move
+    uint32_t *cells;                            // EVAL_BATCH_LANES cells per position
+
+    // walk results
+    float risk[EVAL_BATCH_LANES];
+    int32_t steps[EVAL_BATCH_LANES];
+    int32_t valid[EVAL_BATCH_LANES];
+} BatchGroup;
+
+// Per-move table: index delta and coordinate offsets
+typedef struct {
+    int32_t delta, dx, dy, dz;
+} BatchMove;
+
+#ifdef EVAL_BATCH_X86
+
+static void batch_move_table(const Map3D *map, BatchMove table[EVAL_BATCH_LANES])
+{
+    memset(table, 0, EVAL_BATCH_LANES * sizeof(BatchMove));
+    for (int m = 0; m < MAP_MOVE_COUNT; m++)
+    {
+        table[m].delta = (int32_t)map->move_delta[m];
+        table[m].dx = map_move_offsets[m].x;
+        table[m].dy = map_move_offsets[m].y;
+        table[m].dz = map_move_offsets[m].z;
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void batch_walk_sse4(const Map3D *map, BatchGroup *g)
+{
+    BatchMove table[EVAL_BATCH_LANES];
+    batch_move_table(map, table);
+    const uint32_t *obstacle_words = (const uint32_t *)map->obstacle_bits;
+
+    const __m128i wait = _mm_set1_epi32(DIR_WAIT);
+    const __m128i minus1 = _mm_set1_epi32(-1);
+    const __m128i width = _mm_set1_epi32(map->width);
+    const __m128i height = _mm_set1_epi32(map->height);
+    const __m128i depth = _mm_set1_epi32(map->depth);
+
+    // Two passes of four lanes each
+    for (int base = 0; base < g->lanes; base += 4)
+    {
+        __m128i n = _mm_loadu_si128((const __m128i *)&g->num_moves[base]);
+        __m128i x = _mm_loadu_si128((const __m128i *)&g->x[base]);
+        __m128i y = _mm_loadu_si128((const __m128i *)&g->y[base]);
+        __m128i z = _mm_loadu_si128((const __m128i *)&g->z[base]);
+        __m128i idx = _mm_loadu_si128((const __m128i *)&g->idx[base]);
+        __m128 risk = _mm_setzero_ps();
+        __m128i steps = _mm_setzero_si128();
+        __m128i valid = _mm_cmpgt_epi32(n, _mm_setzero_si128());
+
+        for (int t = 0; ; t++)
+        {
+            int32_t cell[4];
+            _mm_storeu_si128((__m128i *)cell, idx);
+            _mm_storeu_si128((__m128i *)&g->cells[(size_t)t * EVAL_BATCH_LANES + base], idx);
+
+            // No gathers before AVX2: load the four risks one by one
+            int live = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(n, _mm_set1_epi32(t - 1))));
+            __m128 r = _mm_setr_ps(live & 1 ? map->risk_field[cell[0]] : 0.0f,
+                                   live & 2 ? map->risk_field[cell[1]] : 0.0f,
+                                   live & 4 ? map->risk_field[cell[2]] : 0.0f,
+                                   live & 8 ? map->risk_field[cell[3]] : 0.0f);
+            risk = _mm_add_ps(risk, r);
+            if (t == g->max_moves) break;
+
+            __m128i moving = _mm_cmpgt_epi32(n, _mm_set1_epi32(t));
+            uint32_t packed;
+            memcpy(&packed, &g->genes[(size_t)t * EVAL_BATCH_LANES + base], sizeof(packed));
+            __m128i m = _mm_min_epu32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)packed)), wait);
+
+            // Table rows of the four moves, transposed into delta/dx/dy/dz
+            int32_t mv[4];
+            _mm_storeu_si128((__m128i *)mv, m);
+            __m128 r0 = _mm_loadu_ps((const float *)&table[mv[0]]);
+            __m128 r1 = _mm_loadu_ps((const float *)&table[mv[1]]);
+            __m128 r2 = _mm_loadu_ps((const float *)&table[mv[2]]);
+            __m128 r3 = _mm_loadu_ps((const float *)&table[mv[3]]);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            __m128i next = _mm_add_epi32(idx, _mm_castps_si128(r0));
+            __m128i nx = _mm_add_epi32(x, _mm_castps_si128(r1));
+            __m128i ny = _mm_add_epi32(y, _mm_castps_si128(r2));
+            __m128i nz = _mm_add_epi32(z, _mm_castps_si128(r3));
+
+            int32_t nc[4];
+            _mm_storeu_si128((__m128i *)nc, next);
+            int moving_bits = _mm_movemask_ps(_mm_castsi128_ps(moving));
+            __m128i hit = _mm_setr_epi32(
+                (moving_bits & 1) ? -(int32_t)((obstacle_words[(uint32_t)nc[0] >> 5] >> (nc[0] & 31)) & 1u) : 0,
+                (moving_bits & 2) ? -(int32_t)((obstacle_words[(uint32_t)nc[1] >> 5] >> (nc[1] & 31)) & 1u) : 0,
+                (moving_bits & 4) ? -(int32_t)((obstacle_words[(uint32_t)nc[2] >> 5] >> (nc[2] & 31)) & 1u) : 0,
+                (moving_bits & 8) ? -(int32_t)((obstacle_words[(uint32_t)nc[3] >> 5] >> (nc[3] & 31)) & 1u) : 0);
+            valid = _mm_andnot_si128(hit, valid);
+
+            __m128i inside = _mm_and_si128(_mm_cmpgt_epi32(nx, minus1), _mm_cmpgt_epi32(width, nx));
+            inside = _mm_and_si128(inside, _mm_and_si128(_mm_cmpgt_epi32(ny, minus1), _mm_cmpgt_epi32(height, ny)));
+            inside = _mm_and_si128(inside, _mm_and_si128(_mm_cmpgt_epi32(nz, minus1), _mm_cmpgt_epi32(depth, nz)));
+            __m128i take = _mm_and_si128(inside, moving);
+
+            idx = _mm_blendv_epi8(idx, next, take);
+            x = _mm_blendv_epi8(x, nx, take);
+            y = _mm_blendv_epi8(y, ny, take);
+            z = _mm_blendv_epi8(z, nz, take);
+            steps = _mm_sub_epi32(steps, _mm_andnot_si128(_mm_cmpeq_epi32(m, wait), take));
+        }
+
+        _mm_storeu_ps(&g->risk[base], risk);
+        _mm_storeu_si128((__m128i *)&g->steps[base], steps);
+        _mm_storeu_si128((__m128i *)&g->valid[base], valid);
+    }
+}
+
+__attribute__((target("avx2")))
+static void batch_walk_avx2(const Map3D *map, BatchGroup *g)
+{
+    BatchMove table[EVAL_BATCH_LANES];
+    batch_move_table(map, table);
+    const int *obstacle_words = (const int *)map->obstacle_bits;
+
+    int32_t column[4][EVAL_BATCH_LANES];
+    for (int m = 0; m < EVAL_BATCH_LANES; m++)
+    {
+        column[0][m] = table[m].delta;
+        column[1][m] = table[m].dx;
+        column[2][m] = table[m].dy;
+        column[3][m] = table[m].dz;
+    }
+    const __m256i delta = _mm256_loadu_si256((const __m256i *)column[0]);
+    const __m256i dx = _mm256_loadu_si256((const __m256i *)column[1]);
+    const __m256i dy = _mm256_loadu_si256((const __m256i *)column[2]);
+    const __m256i dz = _mm256_loadu_si256((const __m256i *)column[3]);
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i bit = _mm256_set1_epi32(31);
+    const __m256i wait = _mm256_set1_epi32(DIR_WAIT);
+    const __m256i minus1 = _mm256_set1_epi32(-1);
+    const __m256i width = _mm256_set1_epi32(map->width);
+    const __m256i height = _mm256_set1_epi32(map->height);
+    const __m256i depth = _mm256_set1_epi32(map->depth);
+
+    __m256i n = _mm256_loadu_si256((const __m256i *)g->num_moves);
+    __m256i x = _mm256_loadu_si256((const __m256i *)g->x);
+    __m256i y = _mm256_loadu_si256((const __m256i *)g->y);
+    __m256i z = _mm256_loadu_si256((const __m256i *)g->z);
+    __m256i idx = _mm256_loadu_si256((const __m256i *)g->idx);
+    __m256 risk = _mm256_setzero_ps();
+    __m256i steps = zero;
+    __m256i valid = _mm256_cmpgt_epi32(n, zero);
+
+    for (int t = 0; ; t++)
+    {
+        __m256i live = _mm256_cmpgt_epi32(n, _mm256_set1_epi32(t - 1));
+        risk = _mm256_add_ps(risk, _mm256_mask_i32gather_ps(_mm256_setzero_ps(), map->risk_field, idx,
+                                                            _mm256_castsi256_ps(live), 4));
+        _mm256_storeu_si256((__m256i *)&g->cells[(size_t)t * EVAL_BATCH_LANES], idx);
+        if (t == g->max_moves) break;
+
+        __m256i moving = _mm256_cmpgt_epi32(n, _mm256_set1_epi32(t));
+        __m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)&g->genes[(size_t)t * EVAL_BATCH_LANES]));
+        m = _mm256_min_epu32(m, wait);
+
+        __m256i next = _mm256_add_epi32(idx, _mm256_permutevar8x32_epi32(delta, m));
+        __m256i nx = _mm256_add_epi32(x, _mm256_permutevar8x32_epi32(dx, m));
+        __m256i ny = _mm256_add_epi32(y, _mm256_permutevar8x32_epi32(dy, m));
+        __m256i nz = _mm256_add_epi32(z, _mm256_permutevar8x32_epi32(dz, m));
+
+        // Obstacle bit of the target cell, read as 32-bit words
+        __m256i word = _mm256_mask_i32gather_epi32(zero, obstacle_words, _mm256_srli_epi32(next, 5), moving, 4);
+        __m256i hit = _mm256_and_si256(_mm256_srlv_epi32(word, _mm256_and_si256(next, bit)), one);
+        valid = _mm256_andnot_si256(_mm256_cmpeq_epi32(hit, one), valid);
+
+        __m256i inside = _mm256_and_si256(_mm256_cmpgt_epi32(nx, minus1), _mm256_cmpgt_epi32(width, nx));
+        inside = _mm256_and_si256(inside, _mm256_and_si256(_mm256_cmpgt_epi32(ny, minus1), _mm256_cmpgt_epi32(height, ny)));
+        inside = _mm256_and_si256(inside, _mm256_and_si256(_mm256_cmpgt_epi32(nz, minus1), _mm256_cmpgt_epi32(depth, nz)));
+        __m256i take = _mm256_and_si256(inside, moving);
+
+        idx = _mm256_blendv_epi8(idx, next, take);
+        x = _mm256_blendv_epi8(x, nx, take);
+        y = _mm256_blendv_epi8(y, ny, take);
+        z = _mm256_blendv_epi8(z, nz, take);
+        steps = _mm256_sub_epi32(steps, _mm256_andnot_si256(_mm256_cmpeq_epi32(m, wait), take));
+    }
+
+    _mm256_storeu_ps(g->risk, risk);
+    _mm256_storeu_si256((__m256i *)g->steps, steps);
+    _mm256_storeu_si256((__m256i *)g->valid, valid);
+}
+
+#endif // EVAL_BATCH_X86
+
+// ============================================================
+// KERNEL SELECTION
+// ============================================================
+
+static EvalBatchKernel batch_kernel = EVAL_BATCH_AUTO;
+
+bool eval_batch_kernel_supported(EvalBatchKernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef EVAL_BATCH_X86
+        case EVAL_BATCH_AVX2: return __builtin_cpu_supports("avx2");
+        case EVAL_BATCH_SSE4: return __builtin_cpu_supports("sse4.1");
+#endif
+        case EVAL_BATCH_SCALAR:
+        case EVAL_BATCH_AUTO: return true;
+        default: return false;
+    }
+}
+
+const char *eval_batch_kernel_name(EvalBatchKernel kernel)
+{
+    switch (kernel)
+    {
+        case EVAL_BATCH_AVX2: return "AVX2";
+        case EVAL_BATCH_SSE4: return "SSE4.1";
+        case EVAL_BATCH_SCALAR: return "scalar";
+        default: return "auto";
+    }
+}
+
+bool eval_batch_select(EvalBatchKernel kernel)
+{
+    if (!eval_batch_kernel_supported(kernel)) return false;
+
+    // SSE4.1 measures no faster than evaluate_path (its four lanes do not
+    // pay for the transpose and the visit pass), so only AVX2 is automatic
+    if (kernel == EVAL_BATCH_AUTO)
+        kernel = eval_batch_kernel_supported(EVAL_BATCH_AVX2) ? EVAL_BATCH_AVX2 : EVAL_BATCH_SCALAR;
+    batch_kernel = kernel;
+    return true;
+}
+
+EvalBatchKernel eval_batch_kernel(void)
+{
+    if (batch_kernel == EVAL_BATCH_AUTO) eval_batch_select(EVAL_BATCH_AUTO);
+    return batch_kernel;
+}
+
+// The vector walk needs flat cells, obstacle bits, the risk field and
+// constant index deltas, with every index fitting a 32-bit lane
+bool eval_batch_map_supported(const Map3D *map)
+{
+    return map && map->cells && map->obstacle_bits && map->risk_field &&
+           map->layout == MAP_LAYOUT_LINEAR && map->cell_count <= (size_t)INT32_MAX;
+}
+
+// ============================================================
+// BATCH DRIVER
+// ============================================================
+
+static bool batch_reserve(EvalWorkspace *ws, int max_moves)
+{
+    if (ws->batch_genes && ws->batch_capacity >= max_moves) return true;
+
+    free(ws->batch_genes);
+    free(ws->batch_cells);
+    ws->batch_genes = (Gene *)malloc((size_t)(max_moves + 1) * EVAL_BATCH_LANES * sizeof(Gene));
+    ws->batch_cells = (uint32_t *)malloc((size_t)(max_moves + 1) * EVAL_BATCH_LANES * sizeof(uint32_t));
+    ws->batch_capacity = max_moves;
+
+    if (!ws->batch_genes || !ws->batch_cells)
+    {
+        printf("❌ Memory allocation error for batch evaluation\n");
+        free(ws->batch_genes);
+        free(ws->batch_cells);
+        ws->batch_genes = NULL;
+        ws->batch_cells = NULL;
+        ws->batch_capacity = 0;
+        return false;
+    }
+    return true;
+}
+
+// Distinct cells and survivors along one lane of the cell tile
+static void batch_count_visits(const Map3D *map, EvalWorkspace *ws, const BatchGroup *g,
+                               int lane, EvalCheckpoint *state)
+{
+    const uint32_t epoch = eval_next_epoch(ws);
+    uint32_t *survivor_stamp = ws->survivor_stamp;
+
+    for (int t = 0; t <= g->num_moves[lane]; t++)
+    {
+        size_t idx = g->cells[(size_t)t * EVAL_BATCH_LANES + lane];
+        if (!eval_mark_cell(ws, idx, epoch)) continue;
+        state->coverage++;
+
+        int n;
+        const int32_t *ids = map_detectable_survivors(map, idx, &n);
+        for (int k = 0; k < n; k++)
+        {
+            if (survivor_stamp[ids[k]] != epoch)
+            {
+                survivor_stamp[ids[k]] = epoch;
+                state->survivors++;
+            }
+        }
+    }
+}
+
+bool evaluate_paths_batch(const Gene *genes, size_t stride, const int *num_moves,
+                          const Position *starts, int count,
+                          const Map3D *map, EvalWorkspace *ws,
+                          float w_survivors, float w_coverage,
+                          float w_length, float w_risk, PathMetrics *out)
+{
+    if (!genes || !num_moves || !starts || !map || !ws || !out || count < 0) return false;
+
+    const EvalBatchKernel kernel = eval_batch_kernel();
+    if (kernel == EVAL_BATCH_SCALAR || !eval_batch_map_supported(map))
+    {
+        for (int i = 0; i < count; i++)
+            evaluate_path(genes + (size_t)i * stride, num_moves[i], starts[i], map, ws,
+                          w_survivors, w_coverage, w_length, w_risk, &out[i], NULL);
+        return true;
+    }
+
+    for (int first = 0; first < count; first += EVAL_BATCH_LANES)
+    {
+        BatchGroup g;
+        int path_of[EVAL_BATCH_LANES];
+        memset(&g, 0, sizeof(g));
+        for (int lane = 0; lane < EVAL_BATCH_LANES; lane++) g.num_moves[lane] = -1;
+
+        for (int i = first; i < first + EVAL_BATCH_LANES && i < count; i++)
+        {
+            // Off-map starts go through evaluate_path
+            if (!is_valid_position(map, starts[i]))
+            {
+                evaluate_path(genes + (size_t)i * stride, num_moves[i], starts[i], map, ws,
+                              w_survivors, w_coverage, w_length, w_risk, &out[i], NULL);
+                continue;
+            }
+
+            int lane = g.lanes++;
+            path_of[lane] = i;
+            g.num_moves[lane] = num_moves[i];
+            g.x[lane] = starts[i].x;
+            g.y[lane] = starts[i].y;
+            g.z[lane] = starts[i].z;
+            g.idx[lane] = (int32_t)map_pos_index(map, starts[i]);
+            if (num_moves[i] > g.max_moves) g.max_moves = num_moves[i];
+        }
+        if (g.lanes == 0) continue;
+
+        if (!batch_reserve(ws, g.max_moves))
+        {
+            for (int lane = 0; lane < g.lanes; lane++)
+            {
+                int i = path_of[lane];
+                evaluate_path(genes + (size_t)i * stride, num_moves[i], starts[i], map, ws,
+                              w_survivors, w_coverage, w_length, w_risk, &out[i], NULL);
+            }
+            continue;
+        }
+
+        // Transpose to move-major; lanes past their end read WAIT
+        Gene *tile = ws->batch_genes;
+        memset(tile, DIR_WAIT, (size_t)g.max_moves * EVAL_BATCH_LANES * sizeof(Gene));
+        for (int lane = 0; lane < g.lanes; lane++)
+        {
+            const Gene *src = genes + (size_t)path_of[lane] * stride;
+            for (int t = 0; t < g.num_moves[lane]; t++)
+                tile[(size_t)t * EVAL_BATCH_LANES + lane] = src[t];
+        }
+        g.genes = tile;
+        g.cells = ws->batch_cells;
+
+        // Only the vector kernels get here, and only x86 selects them
+#ifdef EVAL_BATCH_X86
+        if (kernel == EVAL_BATCH_AVX2) batch_walk_avx2(map, &g);
+        else batch_walk_sse4(map, &g);
+#endif
+
+        for (int lane = 0; lane < g.lanes; lane++)
+        {
+            EvalCheckpoint state;
+            memset(&state, 0, sizeof(state));
+            state.risk = g.risk[lane];
+            state.steps = g.steps[lane];
+            state.valid = g.valid[lane] != 0;
+            batch_count_visits(map, ws, &g, lane, &state);
+            eval_finish(&state, w_survivors, w_coverage, w_length, w_risk, &out[path_of[lane]]);
+        }
+    }
+    return true;
+}
+
+// ============================================================
+// SELF CHECK
+// ============================================================
+
+static bool metrics_equal(const PathMetrics *a, const PathMetrics *b)
+{
+    return a->fitness == b->fitness && a->survivors_rescued == b->survivors_rescued &&
+           a->coverage_cells == b->coverage_cells && a->total_length == b->total_length &&
+           a->total_risk == b->total_risk && a->time_estimate == b->time_estimate &&
+           a->valid == b->valid;
+}
+
+int eval_batch_self_check(const Map3D *map, int paths, int max_moves)
+{
+    if (!map || paths <= 0 || max_moves < 0) return 0;
+
+    EvalWorkspace *ws = eval_workspace_thread(map);
+    Gene *genes = (Gene *)malloc((size_t)paths * (max_moves + 1) * sizeof(Gene));
+    int *lengths = (int *)malloc(paths * sizeof(int));
+    Position *starts = (Position *)malloc(paths * sizeof(Position));
+    PathMetrics *expected = (PathMetrics *)malloc(paths * sizeof(PathMetrics));
+    PathMetrics *actual = (PathMetrics *)malloc(paths * sizeof(PathMetrics));
+    if (!ws || !genes || !lengths || !starts || !expected || !actual)
+    {
+        printf("❌ Memory allocation error for batch self check\n");
+        free(genes); free(lengths); free(starts); free(expected); free(actual);
+        return -1;
+    }
+
+    // Mixed lengths, all 8 gene values (7 decodes as WAIT) and a few
+    // starts off the map or next to the border
+    Rng rng;
+    rng_seed(&rng, 17, 0);
+    const size_t stride = (size_t)max_moves + 1;
+    rng_fill_bounded_u8(&rng, GENE_MASK + 1, genes, (size_t)paths * stride);
+    for (int i = 0; i < paths; i++)
+    {
+        lengths[i] = (int)rng_bounded(&rng, (uint32_t)max_moves + 1);
+        starts[i] = map->start_position;
+        if (i % 7 == 3)
+            starts[i] = (Position){(int)rng_bounded(&rng, map->width), (int)rng_bounded(&rng, map->height),
+                                   (int)rng_bounded(&rng, map->depth)};
+        if (i % 31 == 5) starts[i].x = -1;
+        evaluate_path(genes + i * stride, lengths[i], starts[i], map, ws,
+                      10.0f, 1.0f, 0.1f, 0.5f, &expected[i], NULL);
+    }
+
+    const EvalBatchKernel saved = eval_batch_kernel();
+    int mismatches = 0;
+    for (int k = EVAL_BATCH_SCALAR; k <= EVAL_BATCH_AVX2; k++)
+    {
+        if (!eval_batch_select((EvalBatchKernel)k)) continue;
+
+        evaluate_paths_batch(genes, stride, lengths, starts, paths, map, ws,
+                             10.0f, 1.0f, 0.1f, 0.5f, actual);
+        for (int i = 0; i < paths; i++)
+        {
+            if (metrics_equal(&expected[i], &actual[i])) continue;
+            if (mismatches++ == 0)
+                printf("⚠️ %s batch kernel differs on path %d: fitness %.3f vs %.3f\n",
+                       eval_batch_kernel_name((EvalBatchKernel)k), i,
+                       actual[i].fitness, expected[i].fitness);
+        }
+    }
+    eval_batch_select(saved);
+
+    free(genes); free(lengths); free(starts); free(expected); free(actual);
+    return mismatches;
+}
@@ -0,0 +1,428 @@
+#include "path_eval.h"
+#include "map_fields.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// WORKSPACE
+// ============================================================
+// Stamps replace per-call visited bitsets: bumping the epoch clears
+// every mark at once, so the buffers are only zeroed on allocation and
+// when the 32-bit epoch wraps. A stamp per cell costs 4 bytes of every
+// cell in every thread's workspace, which sparse and very large maps
+// cannot afford; those mark the cells of the current path in an
+// open-addressing table instead, grown with the path.
+
+static inline bool eval_workspace_dense(const Map3D *map)
+{
+    return !map->bricks && map->cell_count <= EVAL_DENSE_STAMP_MAX_CELLS;
+}
+
+bool eval_workspace_reserve(EvalWorkspace *ws, const Map3D *map)
+{
+    int survivors = map->survivor_count > 0 ? map->survivor_count : 1;
+    const bool dense = eval_workspace_dense(map);
+
+    if (dense && ws->cell_capacity < map->cell_count)
+    {
+        free(ws->cell_stamp);
+        ws->cell_stamp = (uint32_t *)calloc(map->cell_count, sizeof(uint32_t));
+        ws->cell_capacity = ws->cell_stamp ? map->cell_count : 0;
+        ws->epoch = 0;
+    }
+    else if (!dense && ws->cell_stamp)
+    {
+        free(ws->cell_stamp);
+        ws->cell_stamp = NULL;
+        ws->cell_capacity = 0;
+    }
+    if (!dense && !ws->visit_cells)
+    {
+        ws->visit_cells = (size_t *)malloc(EVAL_VISIT_MIN_SLOTS * sizeof(size_t));
+        ws->visit_stamp = (uint32_t *)calloc(EVAL_VISIT_MIN_SLOTS, sizeof(uint32_t));
+        ws->visit_mask = EVAL_VISIT_MIN_SLOTS - 1;
+        ws->epoch = 0;
+    }
+    if (ws->survivor_capacity < survivors)
+    {
+        free(ws->survivor_stamp);
+        ws->survivor_stamp = (uint32_t *)calloc(survivors, sizeof(uint32_t));
+        ws->survivor_capacity = ws->survivor_stamp ? survivors : 0;
+        ws->epoch = 0;
+    }
+
+    if ((dense ? !ws->cell_stamp : !ws->visit_cells || !ws->visit_stamp) || !ws->survivor_stamp)
+    {
+        printf("❌ Memory allocation error for evaluation workspace\n");
+        eval_workspace_release(ws);
+        return false;
+    }
+
+    // Fresh or resized buffers may hold marks from the old epoch range
+    if (ws->epoch == 0)
+    {
+        if (ws->cell_stamp) memset(ws->cell_stamp, 0, ws->cell_capacity * sizeof(uint32_t));
+        if (ws->visit_stamp) memset(ws->visit_stamp, 0, (ws->visit_mask + 1) * sizeof(uint32_t));
+        memset(ws->survivor_stamp, 0, ws->survivor_capacity * sizeof(uint32_t));
+    }
+    return true;
+}
+
+// Doubles the visited-cell table, keeping the cells of the current epoch
+bool eval_visit_grow(EvalWorkspace *ws, uint32_t epoch)
+{
+    size_t slots = (ws->visit_mask + 1) * 2;
+    size_t *cells = (size_t *)malloc(slots * sizeof(size_t));
+    uint32_t *stamp = (uint32_t *)calloc(slots, sizeof(uint32_t));
+    if (!cells || !stamp)
+    {
+        printf("❌ Memory allocation error for visited cells\n");
+        free(cells);
+        free(stamp);
+        return false;
+    }
+
+    for (size_t i = 0; i <= ws->visit_mask; i++)
+    {
+        if (ws->visit_stamp[i] != epoch) continue;
+        size_t slot = (size_t)((ws->visit_cells[i] * 0x9E3779B97F4A7C15ull) >> 32) & (slots - 1);
+        while (stamp[slot] == epoch) slot = (slot + 1) & (slots - 1);
+        stamp[slot] = epoch;
+        cells[slot] = ws->visit_cells[i];
+    }
+
+    free(ws->visit_cells);
+    free(ws->visit_stamp);
+    ws->visit_cells = cells;
+    ws->visit_stamp = stamp;
+    ws->visit_mask = slots - 1;
+    return true;
+}
+
+void eval_workspace_release(EvalWorkspace *ws)
+{
+    if (!ws) return;
+    free(ws->cell_stamp);
+    free(ws->survivor_stamp);
+    free(ws->visit_cells);
+    free(ws->visit_stamp);
+    free(ws->batch_genes);
+    free(ws->batch_cells);
+    memset(ws, 0, sizeof(*ws));
+}
+
+EvalWorkspace *eval_workspace_thread(const Map3D *map)
+{
+    static _Thread_local EvalWorkspace ws;
+    return eval_workspace_reserve(&ws, map) ? &ws : NULL;
+}
+
+uint32_t eval_next_epoch(EvalWorkspace *ws)
+{
+    ws->visit_count = 0;
+    if (++ws->epoch == 0)
+    {
+        if (ws->cell_stamp) memset(ws->cell_stamp, 0, ws->cell_capacity * sizeof(uint32_t));
+        if (ws->visit_stamp) memset(ws->visit_stamp, 0, (ws->visit_mask + 1) * sizeof(uint32_t));
+        memset(ws->survivor_stamp, 0, ws->survivor_capacity * sizeof(uint32_t));
+        ws->epoch = 1;
+    }
+    return ws->epoch;
+}
+
+// ============================================================
+// FUSED EVALUATION KERNEL
+// ============================================================
+// One walk over the moves does what decode, the survivor and coverage
+// counts, path length, risk and validation used to do in six passes:
+//   - moves into the border are dropped (the decoded path is clamped),
+//   - length is the number of moves actually taken (all unit steps),
+//   - survivors are looked up only when a cell is entered for the
+//     first time, since revisits detect the same ones,
+//   - validity fails at the first rubble or border cell a move hits.
+//
+// The walk starts from a saved state: position `first` not yet scored,
+// moves before it applied. With a trace it also records a checkpoint
+// every EVAL_CHECKPOINT_INTERVAL moves and the cells and survivors in
+// first-visit order.
+
+static void eval_walk(const Gene *moves, int num_moves, int first,
+                      const Map3D *map, EvalWorkspace *ws, uint32_t epoch,
+                      EvalCheckpoint *state, EvalTrace *trace, Position *path)
+{
+    uint32_t *survivor_stamp = ws->survivor_stamp;
+
+    Position current = state->pos;
+    size_t idx = state->idx;
+    bool valid = state->valid;
+    int survivors = state->survivors, coverage = state->coverage, steps = state->steps;
+    float risk = state->risk;
+
+    for (int i = first; ; i++)
+    {
+        if (trace && i % EVAL_CHECKPOINT_INTERVAL == 0)
+        {
+            EvalCheckpoint *cp = &trace->checkpoints[i / EVAL_CHECKPOINT_INTERVAL];
+            cp->idx = idx;
+            cp->pos = current;
+            cp->risk = risk;
+            cp->steps = steps;
+            cp->coverage = coverage;
+            cp->survivors = survivors;
+            cp->valid = valid;
+        }
+
+        if (eval_mark_cell(ws, idx, epoch))
+        {
+            if (trace) trace->cells[coverage] = (uint32_t)idx;
+            coverage++;
+
+            int n;
+            const int32_t *ids = map_detectable_survivors(map, idx, &n);
+            for (int k = 0; k < n; k++)
+            {
+                if (survivor_stamp[ids[k]] != epoch)
+                {
+                    survivor_stamp[ids[k]] = epoch;
+                    if (trace) trace->survivors[survivors] = ids[k];
+                    survivors++;
+                }
+            }
+        }
+        risk += map_risk_at(map, idx);
+
+        if (i == num_moves) break;
+
+        int m = moves[i] < MAP_MOVE_COUNT ? moves[i] : DIR_WAIT;
+        size_t next = map_step(map, idx, m);
+
+        if (valid && map_is_obstacle_at(map, next)) valid = false;
+
+        if (map_cell_at(map, next) != CELL_BORDER)
+        {
+            if (m != DIR_WAIT) steps++;
+            idx = next;
+            current.x += map_move_offsets[m].x;
+            current.y += map_move_offsets[m].y;
+            current.z += map_move_offsets[m].z;
+        }
+        if (path) path[i + 1] = current;
+    }
+
+    state->idx = idx;
+    state->pos = current;
+    state->risk = risk;
+    state->steps = steps;
+    state->coverage = coverage;
+    state->survivors = survivors;
+    state->valid = valid;
+}
+
+void eval_initial_state(const Map3D *map, Position start, int num_moves, EvalCheckpoint *state)
+{
+    memset(state, 0, sizeof(*state));
+    state->idx = map_pos_index(map, start);
+    state->pos = start;
+    state->valid = num_moves > 0;
+}
+
+void eval_finish(const EvalCheckpoint *state,
+                 float w_survivors, float w_coverage,
+                 float w_length, float w_risk, PathMetrics *out)
+{
+    out->survivors_rescued = state->survivors;
+    out->coverage_cells = state->coverage;
+    out->total_length = (float)state->steps;
+    out->total_risk = state->risk;
+    out->fitness = (w_survivors * state->survivors) + (w_coverage * state->coverage) -
+                   (w_length * out->total_length) - (w_risk * state->risk);
+    out->time_estimate = out->total_length * 0.5f; // 0.5 seconds per unit
+    out->valid = state->valid;
+}
+
+bool evaluate_path(const Gene *moves, int num_moves, Position start,
+                   const Map3D *map, EvalWorkspace *ws,
+                   float w_survivors, float w_coverage,
+                   float w_length, float w_risk,
+                   PathMetrics *out, Position *path)
+{
+    memset(out, 0, sizeof(*out));
+    if (!moves || !map || !ws) return false;
+
+    if (path) path[0] = start;
+
+    // A start off the map never moves and scores nothing
+    if (!is_valid_position(map, start))
+    {
+        if (path)
+            for (int i = 0; i < num_moves; i++) path[i + 1] = start;
+        return true;
+    }
+
+    EvalCheckpoint state;
+    eval_initial_state(map, start, num_moves, &state);
+    eval_walk(moves, num_moves, 0, map, ws, eval_next_epoch(ws), &state, NULL, path);
+    eval_finish(&state, w_survivors, w_coverage, w_length, w_risk, out);
+    return true;
+}
+
+void eval_continue(const Gene *moves, int num_moves, int first,
+                   const Map3D *map, EvalWorkspace *ws, uint32_t epoch,
+                   EvalCheckpoint *state, EvalTrace *trace,
+                   float w_survivors, float w_coverage,
+                   float w_length, float w_risk, PathMetrics *out)
+{
+    eval_walk(moves, num_moves, first, map, ws, epoch, state, trace, NULL);
+    eval_finish(state, w_survivors, w_coverage, w_length, w_risk, out);
+}
+
+// ============================================================
+// INCREMENTAL EVALUATION
+// ============================================================
+// A trace stays valid for the genes before the chromosome's dirty_from.
+// Resuming restores the last checkpoint at or before that gene, re-marks
+// the cells and survivors recorded before it (a prefix of the first-visit
+// lists) and walks only the rest of the path.
+
+void eval_trace_free(EvalTrace *trace)
+{
+    if (!trace) return;
+    free(trace->checkpoints);
+    free(trace->cells);
+    free(trace->survivors);
+    free(trace);
+}
+
+// Grows the buffers for a path of num_moves, keeping their contents
+bool eval_trace_reserve(EvalTrace *trace, int num_moves, int survivor_count)
+{
+    int checkpoints = num_moves / EVAL_CHECKPOINT_INTERVAL + 1;
+    int cells = num_moves + 1;
+    int survivors = survivor_count > 0 ? survivor_count : 1;
+
+    if (trace->checkpoint_capacity < checkpoints)
+    {
+        EvalCheckpoint *p = (EvalCheckpoint *)realloc(trace->checkpoints, checkpoints * sizeof(EvalCheckpoint));
+        if (!p) return false;
+        trace->checkpoints = p;
+        trace->checkpoint_capacity = checkpoints;
+    }
+    if (trace->cell_capacity < cells)
+    {
+        uint32_t *p = (uint32_t *)realloc(trace->cells, cells * sizeof(uint32_t));
+        if (!p) return false;
+        trace->cells = p;
+        trace->cell_capacity = cells;
+    }
+    if (trace->survivor_capacity < survivors)
+    {
+        int32_t *p = (int32_t *)realloc(trace->survivors, survivors * sizeof(int32_t));
+        if (!p) return false;
+        trace->survivors = p;
+        trace->survivor_capacity = survivors;
+    }
+    return true;
+}
+
+bool eval_trace_copy_prefix(EvalTrace **dst, const EvalTrace *src, int moves)
+{
+    if (!src || src->map_serial == 0 || src->checkpoint_count == 0 || moves < 0)
+    {
+        if (*dst) (*dst)->map_serial = 0;
+        return true;
+    }
+
+    if (!*dst)
+    {
+        *dst = (EvalTrace *)calloc(1, sizeof(EvalTrace));
+        if (!*dst) return false;
+    }
+    EvalTrace *t = *dst;
+
+    int count = moves / EVAL_CHECKPOINT_INTERVAL + 1;
+    if (count > src->checkpoint_count) count = src->checkpoint_count;
+    const EvalCheckpoint *last = &src->checkpoints[count - 1];
+
+    if (!eval_trace_reserve(t, (count - 1) * EVAL_CHECKPOINT_INTERVAL, src->survivor_capacity))
+    {
+        t->map_serial = 0;
+        return false;
+    }
+
+    memcpy(t->checkpoints, src->checkpoints, count * sizeof(EvalCheckpoint));
+    memcpy(t->cells, src->cells, last->coverage * sizeof(uint32_t));
+    memcpy(t->survivors, src->survivors, last->survivors * sizeof(int32_t));
+    t->checkpoint_count = count;
+    t->num_moves = (count - 1) * EVAL_CHECKPOINT_INTERVAL;
+    t->map_serial = src->map_serial;
+    t->start = src->start;
+    return true;
+}
+
+bool evaluate_path_incremental(const Gene *moves, int num_moves, Position start,
+                               const Map3D *map, EvalWorkspace *ws,
+                               EvalTrace *trace, int dirty_from,
+                               float w_survivors, float w_coverage,
+                               float w_length, float w_risk,
+                               PathMetrics *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!moves || !map || !ws || !trace) return false;
+
+    if (!is_valid_position(map, start))
+    {
+        trace->map_serial = 0;
+        return true;
+    }
+    if (!eval_trace_map_supported(map))
+    {
+        trace->map_serial = 0;
+        return evaluate_path(moves, num_moves, start, map, ws, w_survivors, w_coverage,
+                             w_length, w_risk, out, NULL);
+    }
+
+    // Which checkpoint to resume from; 0 means a full walk
+    int resume = 0;
+    if (trace->map_serial == map->serial && trace->checkpoint_count > 0 && positions_equal(trace->start, start))
+    {
+        int from = dirty_from < num_moves ? dirty_from : num_moves;
+        resume = from / EVAL_CHECKPOINT_INTERVAL;
+        if (resume > trace->checkpoint_count - 1) resume = trace->checkpoint_count - 1;
+        if (resume < 0) resume = 0;
+    }
+
+    if (!eval_trace_reserve(trace, num_moves, map->survivor_count))
+    {
+        printf("❌ Memory allocation error for evaluation trace\n");
+        trace->map_serial = 0;
+        return false;
+    }
+
+    const uint32_t epoch = eval_next_epoch(ws);
+    EvalCheckpoint state;
+
+    if (resume > 0)
+    {
+        state = trace->checkpoints[resume];
+        for (int k = 0; k < state.coverage; k++)
+            eval_mark_cell(ws, trace->cells[k], epoch);
+        for (int k = 0; k < state.survivors; k++)
+            ws->survivor_stamp[trace->survivors[k]] = epoch;
+    }
+    else
+    {
+        eval_initial_state(map, start, num_moves, &state);
+    }
+
+    eval_walk(moves, num_moves, resume * EVAL_CHECKPOINT_INTERVAL, map, ws, epoch,
+              &state, trace, NULL);
+
+    trace->map_serial = map->serial;
+    trace->start = start;
+    trace->num_moves = num_moves;
+    trace->checkpoint_count = num_moves / EVAL_CHECKPOINT_INTERVAL + 1;
+
+    eval_finish(&state, w_survivors, w_coverage, w_length, w_risk, out);
+    return true;
+}
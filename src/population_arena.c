@@ -0,0 +1,334 @@
+#include "population_arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+// ============================================================
+// ARENA STORAGE
+// ============================================================
+// One allocation per array for the whole population. Individual i owns
+// genes [i * stride, (i + 1) * stride); nothing is resized afterwards.
+
+bool population_arena_init(PopulationArena *arena, int size, int max_moves)
+{
+    memset(arena, 0, sizeof(*arena));
+    if (size <= 0 || max_moves <= 0) return false;
+
+    arena->size = size;
+    arena->stride = max_moves;
+    arena->genes = (Gene *)malloc((size_t)size * max_moves * sizeof(Gene));
+    arena->num_moves = (int *)calloc(size, sizeof(int));
+    arena->start_pos = (Position *)calloc(size, sizeof(Position));
+    arena->ids = (int *)calloc(size, sizeof(int));
+    arena->fitness = (float *)calloc(size, sizeof(float));
+    arena->survivors_rescued = (int *)calloc(size, sizeof(int));
+    arena->coverage_cells = (int *)calloc(size, sizeof(int));
+    arena->total_length = (float *)calloc(size, sizeof(float));
+    arena->total_risk = (float *)calloc(size, sizeof(float));
+    arena->time_estimate = (float *)calloc(size, sizeof(float));
+    arena->valid = (bool *)calloc(size, sizeof(bool));
+
+    if (!arena->genes || !arena->num_moves || !arena->start_pos || !arena->ids ||
+        !arena->fitness || !arena->survivors_rescued || !arena->coverage_cells ||
+        !arena->total_length || !arena->total_risk || !arena->time_estimate || !arena->valid)
+    {
+        printf("❌ Memory allocation error for population arena\n");
+        population_arena_release(arena);
+        return false;
+    }
+
+    return true;
+}
+
+void population_arena_release(PopulationArena *arena)
+{
+    if (!arena) return;
+
+    free(arena->genes);
+    free(arena->num_moves);
+    free(arena->start_pos);
+    free(arena->ids);
+    free(arena->fitness);
+    free(arena->survivors_rescued);
+    free(arena->coverage_cells);
+    free(arena->total_length);
+    free(arena->total_risk);
+    free(arena->time_estimate);
+    free(arena->valid);
+    memset(arena, 0, sizeof(*arena));
+}
+
+static void arena_clear_results(PopulationArena *arena, int i)
+{
+    arena->fitness[i] = 0.0f;
+    arena->survivors_rescued[i] = 0;
+    arena->coverage_cells[i] = 0;
+    arena->total_length[i] = 0.0f;
+    arena->total_risk[i] = 0.0f;
+    arena->time_estimate[i] = 0.0f;
+    arena->valid[i] = false;
+}
+
+void arena_randomize(PopulationArena *arena, Position start)
+{
+    const uint64_t seed = rng_global_seed();
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < arena->size; i++)
+    {
+        Rng rng;
+        rng_seed(&rng, seed, RNG_STREAM_POPULATION + (uint64_t)i);
+        rng_fill_bounded_u8(&rng, MAP_MOVE_COUNT, arena_genes(arena, i), arena->stride);
+
+        arena->num_moves[i] = arena->stride;
+        arena->start_pos[i] = start;
+        arena->ids[i] = 1000 + i;
+        arena_clear_results(arena, i);
+    }
+}
+
+// ============================================================
+// BREEDING
+// ============================================================
+
+void arena_copy_individual(PopulationArena *dst, int d, const PopulationArena *src, int s)
+{
+    memcpy(arena_genes(dst, d), arena_genes(src, s), src->num_moves[s] * sizeof(Gene));
+
+    dst->num_moves[d] = src->num_moves[s];
+    dst->start_pos[d] = src->start_pos[s];
+    dst->ids[d] = src->ids[s];
+    dst->fitness[d] = src->fitness[s];
+    dst->survivors_rescued[d] = src->survivors_rescued[s];
+    dst->coverage_cells[d] = src->coverage_cells[s];
+    dst->total_length[d] = src->total_length[s];
+    dst->total_risk[d] = src->total_risk[s];
+    dst->time_estimate[d] = src->time_estimate[s];
+    dst->valid[d] = src->valid[s];
+}
+
+// Both arenas share the same stride, so children always fit
+void arena_crossover(Rng *rng, const PopulationArena *src, int p1, int p2,
+                     PopulationArena *dst, int c1, int c2, float crossover_rate)
+{
+    crossover_genes(rng, arena_genes(src, p1), src->num_moves[p1],
+                    arena_genes(src, p2), src->num_moves[p2],
+                    arena_genes(dst, c1), &dst->num_moves[c1],
+                    arena_genes(dst, c2), &dst->num_moves[c2], crossover_rate);
+
+    dst->start_pos[c1] = src->start_pos[p1];
+    dst->start_pos[c2] = src->start_pos[p2];
+    dst->ids[c1] = (int)rng_bounded(rng, 1000000);
+    dst->ids[c2] = (int)rng_bounded(rng, 1000000);
+    arena_clear_results(dst, c1);
+    arena_clear_results(dst, c2);
+}
+
+void arena_mutate(Rng *rng, PopulationArena *arena, int i, float mutation_rate)
+{
+    mutate_genes(rng, arena_genes(arena, i), arena->num_moves[i], mutation_rate);
+}
+
+// ============================================================
+// EVALUATION
+// ============================================================
+// Each thread scores its individuals with the fused kernel in its own
+// workspace; nothing is allocated per individual. With a cache, exact
+// duplicates (up to no-op moves) are looked up instead of walked, and
+// with a prefix cache the rest resume after their longest known prefix.
+// Without either, groups of individuals are walked in SIMD lockstep.
+
+static void arena_store_metrics(PopulationArena *arena, int i, const PathMetrics *m)
+{
+    arena->fitness[i] = m->fitness;
+    arena->survivors_rescued[i] = m->survivors_rescued;
+    arena->coverage_cells[i] = m->coverage_cells;
+    arena->total_length[i] = m->total_length;
+    arena->total_risk[i] = m->total_risk;
+    arena->time_estimate[i] = m->time_estimate;
+    arena->valid[i] = m->valid;
+}
+
+void arena_evaluate(PopulationArena *arena, int first, int count, const Map3D *map,
+                    EvalWorkspace *workspaces, int workspace_count,
+                    FitnessCache *cache, PrefixCache *prefixes,
+                    float w_survivors, float w_coverage,
+                    float w_length, float w_risk)
+{
+    if (!arena || !map || !workspaces || workspace_count <= 0) return;
+
+    if (!cache && !prefixes)
+    {
+        evaluate_population_batch(arena, first, count, map, workspaces, workspace_count,
+                                  w_survivors, w_coverage, w_length, w_risk);
+        return;
+    }
+
+    #pragma omp parallel num_threads(workspace_count)
+    {
+        EvalWorkspace *ws = &workspaces[omp_get_thread_num()];
+
+        #pragma omp for schedule(dynamic, 16)
+        for (int i = first; i < first + count; i++)
+        {
+            PathMetrics m;
+            evaluate_path_cached(arena_genes(arena, i), arena->num_moves[i], arena->start_pos[i],
+                                 map, ws, cache, prefixes, w_survivors, w_coverage, w_length, w_risk, &m);
+            arena_store_metrics(arena, i, &m);
+        }
+    }
+}
+
+void evaluate_population_batch(PopulationArena *arena, int first, int count, const Map3D *map,
+                               EvalWorkspace *workspaces, int workspace_count,
+                               float w_survivors, float w_coverage,
+                               float w_length, float w_risk)
+{
+    if (!arena || !map || !workspaces || workspace_count <= 0 || count <= 0) return;
+
+    // Resolve the kernel before the threads read it
+    eval_batch_kernel();
+    const int groups = (count + EVAL_BATCH_LANES - 1) / EVAL_BATCH_LANES;
+
+    #pragma omp parallel num_threads(workspace_count)
+    {
+        EvalWorkspace *ws = &workspaces[omp_get_thread_num()];
+
+        #pragma omp for schedule(dynamic, 2)
+        for (int g = 0; g < groups; g++)
+        {
+            int i = first + g * EVAL_BATCH_LANES;
+            int n = first + count - i < EVAL_BATCH_LANES ? first + count - i : EVAL_BATCH_LANES;
+            PathMetrics m[EVAL_BATCH_LANES];
+
+            evaluate_paths_batch(arena_genes(arena, i), (size_t)arena->stride, &arena->num_moves[i],
+                                 &arena->start_pos[i], n, map, ws,
+                                 w_survivors, w_coverage, w_length, w_risk, m);
+            for (int k = 0; k < n; k++)
+                arena_store_metrics(arena, i + k, &m[k]);
+        }
+    }
+}
+
+// ============================================================
+// CONVERSION
+// ============================================================
+
+void arena_store_chromosome(PopulationArena *arena, int i, const Chromosome *chrom)
+{
+    int n = chrom->num_moves < arena->stride ? chrom->num_moves : arena->stride;
+    memcpy(arena_genes(arena, i), chrom->moves, n * sizeof(Gene));
+
+    arena->num_moves[i] = n;
+    arena->start_pos[i] = chrom->start_pos;
+    arena->ids[i] = chrom->id;
+    arena->fitness[i] = chrom->fitness;
+    arena->survivors_rescued[i] = chrom->survivors_rescued;
+    arena->coverage_cells[i] = chrom->coverage_cells;
+    arena->total_length[i] = chrom->total_length;
+    arena->total_risk[i] = chrom->total_risk;
+    arena->time_estimate[i] = chrom->time_estimate;
+    arena->valid[i] = chrom->valid;
+}
+
+// chrom must be initialised (moves may be NULL); its buffer is resized
+// to the arena stride when needed
+void arena_load_chromosome(const PopulationArena *arena, int i, Chromosome *chrom)
+{
+    if (!chrom->moves || chrom->max_moves != arena->stride)
+    {
+        free(chrom->moves);
+        chrom->moves = (Gene *)malloc(arena->stride * sizeof(Gene));
+        chrom->max_moves = chrom->moves ? arena->stride : 0;
+        if (!chrom->moves)
+        {
+            printf("❌ Memory allocation error for chromosome\n");
+            chrom->num_moves = 0;
+            return;
+        }
+    }
+    memcpy(chrom->moves, arena_genes(arena, i), arena->num_moves[i] * sizeof(Gene));
+    chromosome_mark_dirty(chrom, 0);
+
+    chrom->num_moves = arena->num_moves[i];
+    chrom->start_pos = arena->start_pos[i];
+    chrom->id = arena->ids[i];
+    chrom->fitness = arena->fitness[i];
+    chrom->survivors_rescued = arena->survivors_rescued[i];
+    chrom->coverage_cells = arena->coverage_cells[i];
+    chrom->total_length = arena->total_length[i];
+    chrom->total_risk = arena->total_risk[i];
+    chrom->time_estimate = arena->time_estimate[i];
+    chrom->valid = arena->valid[i];
+
+    free(chrom->actual_path);
+    chrom->actual_path = NULL;
+    chrom->actual_path_length = 0;
+}
+
+// ============================================================
+// DOUBLE-BUFFERED GENERATIONS
+// ============================================================
+// The current arena is read (selection, elitism) while the next one is
+// written (children); swapping just flips the index.
+
+static void release_workspaces(GenerationArenas *gens)
+{
+    for (int t = 0; t < gens->workspace_count; t++)
+        eval_workspace_release(&gens->workspaces[t]);
+    free(gens->workspaces);
+    gens->workspaces = NULL;
+    gens->workspace_count = 0;
+}
+
+GenerationArenas* create_generation_arenas(int size, int max_moves, const Map3D *map)
+{
+    if (!map) return NULL;
+
+    GenerationArenas *gens = (GenerationArenas *)calloc(1, sizeof(GenerationArenas));
+    if (!gens) return NULL;
+
+    if (!population_arena_init(&gens->arenas[0], size, max_moves) ||
+        !population_arena_init(&gens->arenas[1], size, max_moves))
+    {
+        free_generation_arenas(gens);
+        return NULL;
+    }
+
+    int threads = omp_get_max_threads();
+    gens->workspaces = (EvalWorkspace *)calloc(threads, sizeof(EvalWorkspace));
+    if (!gens->workspaces)
+    {
+        free_generation_arenas(gens);
+        return NULL;
+    }
+    gens->workspace_count = threads;
+
+    for (int t = 0; t < threads; t++)
+    {
+        if (!eval_workspace_reserve(&gens->workspaces[t], map))
+        {
+            free_generation_arenas(gens);
+            return NULL;
+        }
+    }
+
+    return gens;
+}
+
+void free_generation_arenas(GenerationArenas *gens)
+{
+    if (!gens) return;
+
+    population_arena_release(&gens->arenas[0]);
+    population_arena_release(&gens->arenas[1]);
+    release_workspaces(gens);
+    free(gens);
+}
+
+void generation_arenas_swap(GenerationArenas *gens)
+{
+    gens->current ^= 1;
+    gens->generation++;
+}
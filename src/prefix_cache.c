@@ -0,0 +1,386 @@
+#include "prefix_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// PREFIX BLOCK STORAGE
+// ============================================================
+// Entry j of a path describes genes [0, 64j): the walk state after them
+// and the cells and survivors first reached in the last block. Following
+// parent links back to the start yields the full visited sets.
+//
+// Entries and delta lists are bump-allocated; the index is split into
+// one open-addressing table per shard lock. Nothing is removed: when a
+// buffer runs out the cache stops growing until the next clear.
+
+typedef struct {
+    uint64_t lo, hi;             // prefix key
+    int32_t parent;              // entry of the previous block, -1 at the start
+    uint32_t cell_first, cell_count;
+    uint32_t survivor_first, survivor_count;
+    EvalCheckpoint state;        // state at the end of the prefix
+} PrefixEntry;
+
+typedef struct {
+    ShardLock guard;
+    int32_t *slots;                  // entry index, -1 = empty
+    size_t used;
+} PrefixShard;
+
+struct PrefixCache {
+    const Map3D *map;
+    PrefixEntry *entries;
+    int entry_capacity;
+    int entry_count;
+    uint32_t *cells;
+    size_t cell_capacity, cell_count;
+    int32_t *survivors;
+    size_t survivor_capacity, survivor_count;
+    bool full;
+
+    size_t slots_per_shard;          // power of two
+    PrefixShard shards[PREFIX_CACHE_SHARDS];
+
+    uint64_t paths, moves_reused, moves_walked;
+};
+
+PrefixCache* prefix_cache_create(int entries, const Map3D *map)
+{
+    if (!map || entries <= 0) return NULL;
+    if (!eval_trace_map_supported(map))
+    {
+        printf("⚠️  Prefix cache disabled: cell indices of this map do not fit in 32 bits\n");
+        return NULL;
+    }
+
+    PrefixCache *cache = (PrefixCache *)sharded_cache_alloc(sizeof(PrefixCache));
+    if (!cache)
+    {
+        printf("❌ Memory allocation error for prefix cache\n");
+        return NULL;
+    }
+
+    // Index at most half full
+    size_t per_shard = 8;
+    while (per_shard * PREFIX_CACHE_SHARDS < 2 * (size_t)entries) per_shard <<= 1;
+
+    cache->map = map;
+    cache->entry_capacity = entries;
+    cache->entries = (PrefixEntry *)malloc((size_t)entries * sizeof(PrefixEntry));
+    cache->cell_capacity = (size_t)entries * PREFIX_BLOCK_MOVES / 2;
+    cache->cells = (uint32_t *)malloc(cache->cell_capacity * sizeof(uint32_t));
+    cache->survivor_capacity = (size_t)entries * 4;
+    cache->survivors = (int32_t *)malloc(cache->survivor_capacity * sizeof(int32_t));
+    cache->slots_per_shard = per_shard;
+
+    bool ok = cache->entries && cache->cells && cache->survivors;
+    shard_locks_init(cache->shards, sizeof(cache->shards[0]), PREFIX_CACHE_SHARDS);
+    for (int s = 0; s < PREFIX_CACHE_SHARDS; s++)
+    {
+        cache->shards[s].slots = (int32_t *)malloc(per_shard * sizeof(int32_t));
+        if (!cache->shards[s].slots) ok = false;
+    }
+
+    if (!ok)
+    {
+        printf("❌ Memory allocation error for prefix cache\n");
+        prefix_cache_free(cache);
+        return NULL;
+    }
+
+    prefix_cache_clear(cache);
+    return cache;
+}
+
+void prefix_cache_free(PrefixCache *cache)
+{
+    if (!cache) return;
+
+    shard_locks_destroy(cache->shards, sizeof(cache->shards[0]), PREFIX_CACHE_SHARDS);
+    for (int s = 0; s < PREFIX_CACHE_SHARDS; s++)
+        free(cache->shards[s].slots);
+    free(cache->entries);
+    free(cache->cells);
+    free(cache->survivors);
+    free(cache);
+}
+
+void prefix_cache_clear(PrefixCache *cache)
+{
+    if (!cache) return;
+
+    for (int s = 0; s < PREFIX_CACHE_SHARDS; s++)
+    {
+        memset(cache->shards[s].slots, 0xFF, cache->slots_per_shard * sizeof(int32_t));
+        cache->shards[s].used = 0;
+    }
+    cache->entry_count = 0;
+    cache->cell_count = 0;
+    cache->survivor_count = 0;
+    cache->full = false;
+}
+
+void prefix_cache_begin_generation(PrefixCache *cache)
+{
+    if (cache && cache->full) prefix_cache_clear(cache);
+}
+
+// Set by any thread that runs out of room, read by all of them
+static inline bool prefix_cache_full(PrefixCache *cache)
+{
+    bool full;
+    #pragma omp atomic read
+    full = cache->full;
+    return full;
+}
+
+static inline PrefixShard *prefix_shard_of(PrefixCache *cache, GeneKey key)
+{
+    return &cache->shards[key.hi % PREFIX_CACHE_SHARDS];
+}
+
+static int prefix_lookup(PrefixCache *cache, GeneKey key)
+{
+    PrefixShard *shard = prefix_shard_of(cache, key);
+    size_t mask = cache->slots_per_shard - 1;
+    int found = -1;
+
+    shard_lock(&shard->guard);
+    for (size_t s = key.lo & mask; shard->slots[s] >= 0; s = (s + 1) & mask)
+    {
+        const PrefixEntry *e = &cache->entries[shard->slots[s]];
+        if (e->lo == key.lo && e->hi == key.hi)
+        {
+            found = shard->slots[s];
+            break;
+        }
+    }
+    shard_unlock(&shard->guard);
+
+    return found;
+}
+
+// Reserves n items of a bump buffer; false (and the cache marked full)
+// when it does not fit
+static bool prefix_bump(PrefixCache *cache, size_t *count, size_t capacity, size_t n, size_t *first)
+{
+    size_t start;
+    #pragma omp atomic capture
+    { start = *count; *count += n; }
+
+    if (start + n > capacity)
+    {
+        #pragma omp atomic write
+        cache->full = true;
+        return false;
+    }
+    *first = start;
+    return true;
+}
+
+// Returns the entry for key, adding it if absent; -1 when out of room
+static int prefix_insert(PrefixCache *cache, GeneKey key, int parent, const EvalCheckpoint *state,
+                         const uint32_t *cells, int cell_count,
+                         const int32_t *survivors, int survivor_count)
+{
+    PrefixShard *shard = prefix_shard_of(cache, key);
+    size_t mask = cache->slots_per_shard - 1;
+    int result = -1;
+
+    shard_lock(&shard->guard);
+
+    size_t s = key.lo & mask;
+    for (; shard->slots[s] >= 0; s = (s + 1) & mask)
+    {
+        const PrefixEntry *e = &cache->entries[shard->slots[s]];
+        if (e->lo == key.lo && e->hi == key.hi)
+        {
+            result = shard->slots[s];
+            break;
+        }
+    }
+
+    if (result < 0)
+    {
+        int id;
+        #pragma omp atomic capture
+        id = cache->entry_count++;
+
+        size_t cell_first = 0, survivor_first = 0;
+
+        // Probing needs free slots, so shard tables stop at 3/4 full
+        bool room = id < cache->entry_capacity && 4 * (shard->used + 1) <= 3 * cache->slots_per_shard &&
+                    prefix_bump(cache, &cache->cell_count, cache->cell_capacity, cell_count, &cell_first) &&
+                    prefix_bump(cache, &cache->survivor_count, cache->survivor_capacity, survivor_count, &survivor_first);
+
+        if (room)
+        {
+            PrefixEntry *e = &cache->entries[id];
+            e->lo = key.lo;
+            e->hi = key.hi;
+            e->parent = parent;
+            e->state = *state;
+            e->cell_first = (uint32_t)cell_first;
+            e->cell_count = (uint32_t)cell_count;
+            e->survivor_first = (uint32_t)survivor_first;
+            e->survivor_count = (uint32_t)survivor_count;
+            memcpy(&cache->cells[cell_first], cells, cell_count * sizeof(uint32_t));
+            memcpy(&cache->survivors[survivor_first], survivors, survivor_count * sizeof(int32_t));
+            shard->slots[s] = id;
+            shard->used++;
+            result = id;
+        }
+        else
+        {
+            #pragma omp atomic write
+            cache->full = true;
+        }
+    }
+
+    shard_unlock(&shard->guard);
+    return result;
+}
+
+// ============================================================
+// PREFIX KEYS
+// ============================================================
+// Key j covers genes [0, 64j) of the raw sequence plus the start cell;
+// each key extends the previous one by one block.
+
+static void prefix_keys(const Gene *moves, int blocks, size_t start_idx, GeneKey *keys)
+{
+    gene_key_init(&keys[0]);
+    gene_key_finish(&keys[0], start_idx);
+
+    for (int j = 0; j < blocks; j++)
+    {
+        const Gene *block = moves + (size_t)j * PREFIX_BLOCK_MOVES;
+        GeneKey key = keys[j];
+
+        for (int w = 0; w < PREFIX_BLOCK_MOVES / 8; w++)
+        {
+            uint64_t word;
+            memcpy(&word, block + 8 * w, sizeof(word));
+            gene_key_add_word(&key, word, (uint64_t)w);
+        }
+        gene_key_finish(&key, 0);
+        keys[j + 1] = key;
+    }
+}
+
+// ============================================================
+// PREFIXED EVALUATION
+// ============================================================
+
+bool evaluate_path_prefixed(const Gene *moves, int num_moves, Position start,
+                            const Map3D *map, EvalWorkspace *ws, PrefixCache *cache,
+                            float w_survivors, float w_coverage,
+                            float w_length, float w_risk, PathMetrics *out)
+{
+    static _Thread_local EvalTrace trace;
+    static _Thread_local GeneKey *keys;
+    static _Thread_local int key_capacity;
+
+    if (!cache || cache->map != map || !is_valid_position(map, start))
+        return evaluate_path(moves, num_moves, start, map, ws, w_survivors, w_coverage,
+                             w_length, w_risk, out, NULL);
+
+    const int blocks = num_moves / PREFIX_BLOCK_MOVES;
+    if (key_capacity < blocks + 1)
+    {
+        GeneKey *grown = (GeneKey *)realloc(keys, (blocks + 1) * sizeof(GeneKey));
+        if (!grown)
+            return evaluate_path(moves, num_moves, start, map, ws, w_survivors, w_coverage,
+                                 w_length, w_risk, out, NULL);
+        keys = grown;
+        key_capacity = blocks + 1;
+    }
+    if (!eval_trace_reserve(&trace, num_moves, map->survivor_count))
+        return evaluate_path(moves, num_moves, start, map, ws, w_survivors, w_coverage,
+                             w_length, w_risk, out, NULL);
+
+    prefix_keys(moves, blocks, map_pos_index(map, start), keys);
+
+    // Longest stored prefix
+    int reused = 0, entry = -1;
+    while (reused < blocks)
+    {
+        int e = prefix_lookup(cache, keys[reused + 1]);
+        if (e < 0) break;
+        entry = e;
+        reused++;
+    }
+
+    const uint32_t epoch = eval_next_epoch(ws);
+    EvalCheckpoint state;
+
+    if (entry >= 0)
+    {
+        state = cache->entries[entry].state;
+        for (int e = entry; e >= 0; e = cache->entries[e].parent)
+        {
+            const PrefixEntry *pe = &cache->entries[e];
+            for (uint32_t k = 0; k < pe->cell_count; k++)
+                eval_mark_cell(ws, cache->cells[pe->cell_first + k], epoch);
+            for (uint32_t k = 0; k < pe->survivor_count; k++)
+                ws->survivor_stamp[cache->survivors[pe->survivor_first + k]] = epoch;
+        }
+    }
+    else
+    {
+        eval_initial_state(map, start, num_moves, &state);
+    }
+
+    const int first = reused * PREFIX_BLOCK_MOVES;
+    eval_continue(moves, num_moves, first, map, ws, epoch, &state, &trace,
+                  w_survivors, w_coverage, w_length, w_risk, out);
+
+    // Store the blocks this walk completed
+    int parent = entry;
+    for (int j = reused + 1; j <= blocks && !prefix_cache_full(cache); j++)
+    {
+        const EvalCheckpoint *before = &trace.checkpoints[j - 1];
+        const EvalCheckpoint *after = &trace.checkpoints[j];
+        parent = prefix_insert(cache, keys[j], parent, after,
+                               &trace.cells[before->coverage], after->coverage - before->coverage,
+                               &trace.survivors[before->survivors], after->survivors - before->survivors);
+        if (parent < 0) break;
+    }
+
+    #pragma omp atomic
+    cache->paths++;
+    #pragma omp atomic
+    cache->moves_reused += first;
+    #pragma omp atomic
+    cache->moves_walked += num_moves - first;
+
+    return true;
+}
+
+// ============================================================
+// STATISTICS
+// ============================================================
+
+void prefix_cache_get_stats(PrefixCache *cache, PrefixCacheStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (!cache) return;
+
+    stats->paths = cache->paths;
+    stats->moves_reused = cache->moves_reused;
+    stats->moves_walked = cache->moves_walked;
+    stats->entries = cache->entry_count < cache->entry_capacity ? cache->entry_count : cache->entry_capacity;
+    stats->capacity = cache->entry_capacity;
+}
+
+void prefix_cache_print_stats(PrefixCache *cache)
+{
+    PrefixCacheStats stats;
+    prefix_cache_get_stats(cache, &stats);
+
+    uint64_t total = stats.moves_reused + stats.moves_walked;
+    printf("🌳 Prefix cache: %.1f%% of moves reused over %llu paths, %d/%d blocks stored\n",
+           total ? 100.0 * stats.moves_reused / total : 0.0,
+           (unsigned long long)stats.paths, stats.entries, stats.capacity);
+}
@@ -0,0 +1,260 @@
+#include "ranking.h"
+#include "chromosome.h"
+#include "selection.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================
+// RADIX SORT ON FLOAT KEYS
+// ============================================================
+// IEEE floats order like integers once negative values have all bits
+// flipped and positive ones only the sign bit; descending order flips
+// every bit again. One pass builds the four byte histograms, and a byte
+// position shared by every key is skipped.
+
+static inline uint32_t fitness_radix_key(float f, bool descending)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    u ^= (u >> 31) ? 0xFFFFFFFFu : 0x80000000u;
+    return descending ? ~u : u;
+}
+
+void fitness_keys_radix_sort(FitnessKey *keys, FitnessKey *scratch, int count, bool descending)
+{
+    if (!keys || !scratch || count < 2) return;
+
+    uint32_t histogram[4][256];
+    memset(histogram, 0, sizeof(histogram));
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t u = fitness_radix_key(keys[i].fitness, descending);
+        for (int b = 0; b < 4; b++)
+            histogram[b][(u >> (8 * b)) & 0xFF]++;
+    }
+
+    FitnessKey *src = keys, *dst = scratch;
+    for (int b = 0; b < 4; b++)
+    {
+        uint32_t *h = histogram[b];
+        const uint32_t first = h[(fitness_radix_key(src[0].fitness, descending) >> (8 * b)) & 0xFF];
+        if (first == (uint32_t)count) continue;
+
+        uint32_t offset = 0;
+        for (int v = 0; v < 256; v++)
+        {
+            uint32_t n = h[v];
+            h[v] = offset;
+            offset += n;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            uint32_t u = fitness_radix_key(src[i].fitness, descending);
+            dst[h[(u >> (8 * b)) & 0xFF]++] = src[i];
+        }
+
+        FitnessKey *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != keys) memcpy(keys, src, count * sizeof(FitnessKey));
+}
+
+// ============================================================
+// TOP-K AND PARTIAL SELECTION
+// ============================================================
+
+// Higher fitness first, then the lower index
+static inline bool key_better(FitnessKey a, FitnessKey b)
+{
+    return a.fitness > b.fitness || (a.fitness == b.fitness && a.index < b.index);
+}
+
+// Min-heap on key_better: the root is the worst key kept
+static void heap_sift_down(FitnessKey *heap, int size, int i)
+{
+    for (;;)
+    {
+        int worst = i, l = 2 * i + 1, r = l + 1;
+        if (l < size && key_better(heap[worst], heap[l])) worst = l;
+        if (r < size && key_better(heap[worst], heap[r])) worst = r;
+        if (worst == i) return;
+
+        FitnessKey t = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = t;
+        i = worst;
+    }
+}
+
+int fitness_keys_top_k(const FitnessKey *keys, int count, int k, FitnessKey *out)
+{
+    if (!keys || !out || count <= 0 || k <= 0) return 0;
+    if (k > count) k = count;
+
+    memcpy(out, keys, k * sizeof(FitnessKey));
+    for (int i = k / 2 - 1; i >= 0; i--) heap_sift_down(out, k, i);
+
+    for (int i = k; i < count; i++)
+    {
+        if (key_better(keys[i], out[0]))
+        {
+            out[0] = keys[i];
+            heap_sift_down(out, k, 0);
+        }
+    }
+
+    // Heap sort: moving the worst root to the back leaves the best first
+    for (int size = k - 1; size > 0; size--)
+    {
+        FitnessKey t = out[0];
+        out[0] = out[size];
+        out[size] = t;
+        heap_sift_down(out, size, 0);
+    }
+    return k;
+}
+
+static inline float median3(float a, float b, float c)
+{
+    if (a > b) { float t = a; a = b; b = t; }
+    if (b > c) b = c;
+    return a > b ? a : b;
+}
+
+void fitness_select_top(const float *fitness, int count, int k, int32_t *order)
+{
+    for (int i = 0; i < count; i++) order[i] = i;
+
+    int lo = 0, hi = count - 1;
+    while (lo < hi)
+    {
+        float pivot = median3(fitness[order[lo]], fitness[order[lo + (hi - lo) / 2]], fitness[order[hi]]);
+        int i = lo, j = hi;
+        while (i <= j)
+        {
+            while (fitness[order[i]] > pivot) i++;
+            while (fitness[order[j]] < pivot) j--;
+            if (i <= j)
+            {
+                int32_t t = order[i];
+                order[i] = order[j];
+                order[j] = t;
+                i++;
+                j--;
+            }
+        }
+
+        // [lo, j] >= pivot >= [i, hi]; anything between equals the pivot
+        if (k - 1 <= j) hi = j;
+        else if (k - 1 >= i) lo = i;
+        else break;
+    }
+}
+
+// ============================================================
+// POPULATION RANKING AND STATISTICS
+// ============================================================
+// The ranking works on (fitness, index) keys; statistics come out of
+// the same pass that fills them.
+
+static void population_scan(Population *pop, FitnessKey *keys)
+{
+    int best = 0, worst = 0;
+    double sum = 0.0;
+
+    for (int i = 0; i < pop->size; i++)
+    {
+        float f = pop->individuals[i].fitness;
+        if (keys)
+        {
+            keys[i].fitness = f;
+            keys[i].index = i;
+        }
+        sum += f;
+        if (f > pop->individuals[best].fitness) best = i;
+        if (f < pop->individuals[worst].fitness) worst = i;
+    }
+
+    pop->best = &pop->individuals[best];
+    pop->best_fitness = pop->individuals[best].fitness;
+    pop->worst_fitness = pop->individuals[worst].fitness;
+    pop->avg_fitness = (float)(sum / pop->size);
+}
+
+void calculate_population_stats(Population *pop)
+{
+    if (!pop || pop->size <= 0) return;
+    population_scan(pop, NULL);
+}
+
+// Best first. Each Chromosome is moved once, following the cycles of
+// the permutation.
+void sort_population_by_fitness(Population *pop)
+{
+    if (!pop || pop->size <= 0) return;
+
+    const int n = pop->size;
+    FitnessKey *keys = (FitnessKey *)malloc(2 * (size_t)n * sizeof(FitnessKey));
+    if (!keys)
+    {
+        printf("❌ Memory allocation error for population sort\n");
+        return;
+    }
+
+    population_scan(pop, keys);
+    fitness_keys_radix_sort(keys, keys + n, n, true);
+
+    // keys[i].index = old position of the individual that goes to i;
+    // placed slots are marked with -1
+    for (int start = 0; start < n; start++)
+    {
+        if (keys[start].index < 0 || keys[start].index == start)
+        {
+            keys[start].index = -1;
+            continue;
+        }
+
+        Chromosome held = pop->individuals[start];
+        int dst = start;
+        for (;;)
+        {
+            int src = keys[dst].index;
+            keys[dst].index = -1;
+            if (src == start)
+            {
+                pop->individuals[dst] = held;
+                break;
+            }
+            pop->individuals[dst] = pop->individuals[src];
+            dst = src;
+        }
+    }
+    free(keys);
+
+    pop->best = &pop->individuals[0];
+    if (pop->selection) pop->selection->generation = -1;
+}
+
+Chromosome* get_best_chromosome(Population *pop)
+{
+    if (!pop || pop->size <= 0) return NULL;
+
+    int best = 0;
+    for (int i = 1; i < pop->size; i++)
+        if (pop->individuals[i].fitness > pop->individuals[best].fitness) best = i;
+    return &pop->individuals[best];
+}
+
+Chromosome* get_worst_chromosome(Population *pop)
+{
+    if (!pop || pop->size <= 0) return NULL;
+
+    int worst = 0;
+    for (int i = 1; i < pop->size; i++)
+        if (pop->individuals[i].fitness < pop->individuals[worst].fitness) worst = i;
+    return &pop->individuals[worst];
+}
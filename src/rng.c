@@ -0,0 +1,98 @@
+#include "rng.h"
+#include <stdbool.h>
+
+// ============= Seeding =============
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream)
+{
+    // Mix the stream id through its own splitmix step so that
+    // neighbouring streams start from unrelated states
+    uint64_t mixer = stream;
+    uint64_t state = seed ^ splitmix64(&mixer);
+
+    for (int i = 0; i < 4; i++)
+        rng->s[i] = splitmix64(&state);
+
+    // xoshiro must not start from the all-zero state
+    if (!(rng->s[0] | rng->s[1] | rng->s[2] | rng->s[3]))
+        rng->s[0] = 1;
+}
+
+// ============= Global seed and per-thread default streams =============
+
+static uint64_t global_seed = 0x5EED5EED5EED5EEDULL;
+static unsigned global_epoch = 1;
+static unsigned thread_counter = 0;
+
+static _Thread_local Rng thread_rng;
+static _Thread_local unsigned thread_epoch = 0;
+static _Thread_local unsigned thread_slot = 0;
+static _Thread_local bool thread_has_slot = false;
+
+void rng_set_global_seed(uint64_t seed)
+{
+    global_seed = seed;
+    __atomic_add_fetch(&global_epoch, 1, __ATOMIC_RELEASE);
+}
+
+uint64_t rng_global_seed(void)
+{
+    return global_seed;
+}
+
+Rng *rng_thread(void)
+{
+    unsigned epoch = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+
+    if (thread_epoch != epoch) {
+        // The first thread to ask (normally main) gets slot 0
+        if (!thread_has_slot) {
+            thread_slot = __atomic_fetch_add(&thread_counter, 1, __ATOMIC_RELAXED);
+            thread_has_slot = true;
+        }
+        rng_seed(&thread_rng, global_seed, RNG_STREAM_THREAD + thread_slot);
+        thread_epoch = epoch;
+    }
+
+    return &thread_rng;
+}
+
+// ============= Bulk generation =============
+
+void rng_fill_bounded(Rng *rng, uint32_t bound, uint32_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = rng_bounded(rng, bound);
+}
+
+// Four 16-bit Lemire draws per 64-bit output; fits small alphabets
+// such as the 7 move directions
+void rng_fill_bounded_u8(Rng *rng, uint8_t bound, uint8_t *out, size_t n)
+{
+    uint32_t threshold = (uint32_t)(65536u % bound);
+    size_t i = 0;
+
+    while (i < n) {
+        uint64_t bits = rng_next(rng);
+        for (int k = 0; k < 4 && i < n; k++, bits >>= 16) {
+            uint32_t m = (uint32_t)(bits & 0xFFFF) * bound;
+            if ((m & 0xFFFF) < threshold)
+                continue;  // rejected, keeps the draw unbiased
+            out[i++] = (uint8_t)(m >> 16);
+        }
+    }
+}
+
+void rng_fill_float(Rng *rng, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = rng_float(rng);
+}
@@ -0,0 +1,270 @@
+#include "selection.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// ALIAS TABLE (VOSE)
+// ============================================================
+// Every slot holds its own item with probability prob[i] and alias[i]
+// otherwise, so a draw is one random slot and one comparison. Building
+// pairs each under-full slot with an over-full one in a single pass.
+
+static bool alias_table_reserve(AliasTable *table, int count)
+{
+    if (table->capacity >= count) return true;
+
+    float *prob = (float *)realloc(table->prob, count * sizeof(float));
+    if (prob) table->prob = prob;
+    int32_t *alias = (int32_t *)realloc(table->alias, count * sizeof(int32_t));
+    if (alias) table->alias = alias;
+    int32_t *scratch = (int32_t *)realloc(table->scratch, count * sizeof(int32_t));
+    if (scratch) table->scratch = scratch;
+
+    if (!prob || !alias || !scratch) return false;
+    table->capacity = count;
+    return true;
+}
+
+bool alias_table_build(AliasTable *table, const float *weights, int count)
+{
+    if (!table || !weights || count <= 0) return false;
+    if (!alias_table_reserve(table, count))
+    {
+        printf("❌ Memory allocation error for alias table\n");
+        return false;
+    }
+    table->size = count;
+
+    double total = 0.0;
+    for (int i = 0; i < count; i++) total += weights[i];
+
+    if (!(total > 0.0))
+    {
+        for (int i = 0; i < count; i++)
+        {
+            table->prob[i] = 1.0f;
+            table->alias[i] = i;
+        }
+        return true;
+    }
+
+    // Scaled weights (mean 1) go in prob; small slots fill the scratch
+    // array from the front, large ones from the back
+    const double scale = count / total;
+    int32_t *small = table->scratch;
+    int32_t *large = table->scratch + count;
+    int n_small = 0, n_large = 0;
+    for (int i = 0; i < count; i++)
+    {
+        table->prob[i] = (float)(weights[i] * scale);
+        table->alias[i] = i;
+        if (table->prob[i] < 1.0f)
+            small[n_small++] = i;
+        else
+        {
+            *--large = i;
+            n_large++;
+        }
+    }
+
+    while (n_small > 0 && n_large > 0)
+    {
+        int s = small[--n_small];
+        int l = large[0];
+
+        table->alias[s] = l;
+        table->prob[l] -= 1.0f - table->prob[s];
+        if (table->prob[l] < 1.0f)
+        {
+            // l is now small: move it from the large list to the small one
+            large++;
+            n_large--;
+            small[n_small++] = l;
+        }
+    }
+
+    // Rounding leftovers keep their own slot
+    for (int k = 0; k < n_large; k++) table->prob[large[k]] = 1.0f;
+    for (int k = 0; k < n_small; k++) table->prob[small[k]] = 1.0f;
+    return true;
+}
+
+void alias_table_release(AliasTable *table)
+{
+    if (!table) return;
+    free(table->prob);
+    free(table->alias);
+    free(table->scratch);
+    memset(table, 0, sizeof(*table));
+}
+
+// ============================================================
+// PER-GENERATION TABLES
+// ============================================================
+// Built once after evaluation: a packed fitness copy for tournaments,
+// the alias table over shifted fitness for roulette, and an index
+// permutation from worst to best for ranking. Linear rank weights only
+// depend on the population size, so that alias table is reused across
+// generations and a draw returns a rank, mapped through the permutation.
+
+static bool selection_tables_reserve(SelectionTables *tables, int size)
+{
+    if (tables->capacity >= size) return true;
+
+    float *fitness = (float *)realloc(tables->fitness, size * sizeof(float));
+    if (fitness) tables->fitness = fitness;
+    FitnessKey *ranked = (FitnessKey *)realloc(tables->ranked, size * sizeof(FitnessKey));
+    if (ranked) tables->ranked = ranked;
+    FitnessKey *scratch = (FitnessKey *)realloc(tables->scratch, size * sizeof(FitnessKey));
+    if (scratch) tables->scratch = scratch;
+    float *weights = (float *)realloc(tables->weights, size * sizeof(float));
+    if (weights) tables->weights = weights;
+
+    if (!fitness || !ranked || !scratch || !weights) return false;
+    tables->capacity = size;
+    return true;
+}
+
+bool prepare_selection(Population *pop)
+{
+    if (!pop || pop->size <= 0) return false;
+
+    if (!pop->selection)
+    {
+        pop->selection = (SelectionTables *)calloc(1, sizeof(SelectionTables));
+        if (!pop->selection)
+        {
+            printf("❌ Memory allocation error for selection tables\n");
+            return false;
+        }
+    }
+    SelectionTables *tables = pop->selection;
+    tables->generation = -1;
+
+    const int n = pop->size;
+    if (!selection_tables_reserve(tables, n))
+    {
+        printf("❌ Memory allocation error for selection tables\n");
+        return false;
+    }
+    tables->size = n;
+
+    float low = pop->individuals[0].fitness;
+    for (int i = 0; i < n; i++)
+    {
+        float f = pop->individuals[i].fitness;
+        tables->fitness[i] = f;
+        tables->ranked[i].fitness = f;
+        tables->ranked[i].index = i;
+        if (f < low) low = f;
+    }
+
+    // Roulette: shifted so the worst individual has weight zero
+    for (int i = 0; i < n; i++)
+        tables->weights[i] = tables->fitness[i] - low;
+    if (!alias_table_build(&tables->roulette, tables->weights, n)) return false;
+
+    // Rank: weight (2 - sp) + 2 (sp - 1) r / (n - 1) for rank r from the worst
+    fitness_keys_radix_sort(tables->ranked, tables->scratch, n, false);
+    if (tables->rank_size != n)
+    {
+        const float sp = RANK_SELECTION_PRESSURE;
+        for (int r = 0; r < n; r++)
+            tables->weights[r] = n > 1 ? (2.0f - sp) + 2.0f * (sp - 1.0f) * r / (n - 1) : 1.0f;
+        if (!alias_table_build(&tables->rank, tables->weights, n)) return false;
+        tables->rank_size = n;
+    }
+
+    tables->generation = pop->generation;
+    return true;
+}
+
+void selection_tables_free(SelectionTables *tables)
+{
+    if (!tables) return;
+    free(tables->fitness);
+    free(tables->ranked);
+    free(tables->scratch);
+    free(tables->weights);
+    alias_table_release(&tables->roulette);
+    alias_table_release(&tables->rank);
+    free(tables);
+}
+
+// Tables are used only if built for this generation and size
+static const SelectionTables *current_tables(const Population *pop)
+{
+    const SelectionTables *t = pop->selection;
+    return t && t->generation == pop->generation && t->size == pop->size ? t : NULL;
+}
+
+// ============================================================
+// SELECTION OPERATORS
+// ============================================================
+
+Chromosome* tournament_selection(const Population *pop, int tournament_size)
+{
+    if (!pop || pop->size <= 0) return NULL;
+
+    Rng *rng = rng_thread();
+    const int k = tournament_size > 0 ? tournament_size : 1;
+    const SelectionTables *t = current_tables(pop);
+    if (t) return &pop->individuals[tournament_select_index(rng, t->fitness, pop->size, k)];
+
+    int best = (int)rng_bounded(rng, (uint32_t)pop->size);
+    for (int i = 1; i < k; i++)
+    {
+        int c = (int)rng_bounded(rng, (uint32_t)pop->size);
+        if (pop->individuals[c].fitness > pop->individuals[best].fitness) best = c;
+    }
+    return &pop->individuals[best];
+}
+
+Chromosome* roulette_wheel_selection(const Population *pop)
+{
+    if (!pop || pop->size <= 0) return NULL;
+
+    Rng *rng = rng_thread();
+    const SelectionTables *t = current_tables(pop);
+    if (t) return &pop->individuals[alias_table_sample(&t->roulette, rng)];
+
+    // No tables: two linear passes over the population
+    float low = pop->individuals[0].fitness;
+    double total = 0.0;
+    for (int i = 0; i < pop->size; i++)
+        if (pop->individuals[i].fitness < low) low = pop->individuals[i].fitness;
+    for (int i = 0; i < pop->size; i++)
+        total += pop->individuals[i].fitness - low;
+    if (!(total > 0.0)) return &pop->individuals[rng_bounded(rng, (uint32_t)pop->size)];
+
+    double target = rng_float(rng) * total;
+    for (int i = 0; i < pop->size; i++)
+    {
+        target -= pop->individuals[i].fitness - low;
+        if (target < 0.0) return &pop->individuals[i];
+    }
+    return &pop->individuals[pop->size - 1];
+}
+
+Chromosome* rank_selection(const Population *pop)
+{
+    if (!pop || pop->size <= 0) return NULL;
+
+    Rng *rng = rng_thread();
+    const SelectionTables *t = current_tables(pop);
+    if (t) return &pop->individuals[t->ranked[alias_table_sample(&t->rank, rng)].index];
+
+    // No ranking available: a binary tournament whose better entrant wins
+    // with probability sp / 2 approaches the same linear rank weights as
+    // the population grows
+    int a = (int)rng_bounded(rng, (uint32_t)pop->size);
+    int b = (int)rng_bounded(rng, (uint32_t)pop->size);
+    if (pop->individuals[a].fitness < pop->individuals[b].fitness)
+    {
+        int s = a;
+        a = b;
+        b = s;
+    }
+    return &pop->individuals[rng_float(rng) < RANK_SELECTION_PRESSURE * 0.5f ? a : b];
+}